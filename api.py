@@ -1,3 +1,9 @@
+import io
+import re
+import sys
+
+# --dispatch emits the runtime-dispatched api, see neon_dispatch.h
+dispatch = "--dispatch" in sys.argv[1:]
 
 sint_neon_types = ["s8", "s16", "s32", "s64"]
 uint_neon_types = ["u8", "u16", "u32", "u64"]
@@ -42,8 +48,11 @@ uint_narrow_types = {"u16": "u8", "u32": "u16", "u64": "u32" }
 narrow_types  = sint_narrow_types
 narrow_types .update(uint_narrow_types )
 
-def default_api(abbrev, inputtypes, nargs):
-    for size in [8, 16]:
+def arg(ctype):
+    return f"neon::arg<{ctype}>"
+
+def default_api(abbrev, inputtypes, nargs, sizes=[8, 16]):
+    for size in sizes:
         for inputtype in inputtypes:
             
             fname = f"{abbrev}q_{inputtype}" if size == 16 else f"{abbrev}_{inputtype}"
@@ -54,7 +63,7 @@ def default_api(abbrev, inputtypes, nargs):
             rettype = basetype
 
 
-            args = [(basetype + " const&", "a")]*n
+            args = [(arg(basetype), "a")]*nargs
 
             if nargs > 1: 
                 args = [(args[i][0], args[i][1] + f"{i}") for i in range(nargs)]
@@ -67,6 +76,10 @@ def default_api(abbrev, inputtypes, nargs):
             #print (inputtype, rett)
             print(f"inline {rettype} {fname}({fn_arglist}) {{ return neon::{f}({arglist}); }}")
 
+def q_api(abbrev, inputtypes, nargs):
+    # Ops that only exist on 128-bit registers (SHA3 extension)
+    default_api(abbrev, inputtypes, nargs, sizes=[16])
+
 def vaddl_high_api(abbrev, inputtypes, nargs):
     
     for inputtype in inputtypes:
@@ -77,7 +90,7 @@ def vaddl_high_api(abbrev, inputtypes, nargs):
         basetype = f"{neon_type2ctype[inputtype]}x{int(16/neon_type2size[inputtype]) }_t"
 
         
-        args = [(basetype + " const&", f"a{i}") for i in range(nargs) ]
+        args = [(arg(basetype), f"a{i}") for i in range(nargs) ]
 
         fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
 
@@ -95,7 +108,7 @@ def vaddl_api(abbrev, inputtypes, nargs):
         basetype = f"{neon_type2ctype[inputtype]}x{int(8/neon_type2size[inputtype]) }_t"
 
         
-        args = [(basetype + " const&", f"a{i}") for i in range(nargs) ]
+        args = [(arg(basetype), f"a{i}") for i in range(nargs) ]
 
         fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
 
@@ -112,7 +125,7 @@ def widening64_op(abbrev, inputtypes, nargs):
         dtype = f"{neon_type2ctype[inputtype]}x{int(8/neon_type2size[inputtype]) }_t"
 
         
-        args = [(qtype + " const&", "a0"), (dtype + " const&", "a1")]
+        args = [(arg(qtype), "a0"), (arg(dtype), "a1")]
 
         fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
 
@@ -129,7 +142,7 @@ def widening128_op(abbrev, inputtypes, nargs):
         dtype = f"{neon_type2ctype[inputtype]}x{int(16/neon_type2size[inputtype]) }_t"
 
         
-        args = [(qtype + " const&", "a0"), (dtype + " const&", "a1")]
+        args = [(arg(qtype), "a0"), (arg(dtype), "a1")]
 
         fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
 
@@ -141,12 +154,14 @@ def narrow64_op(abbrev, inputtypes, nargs):
         fname = f"{abbrev}_{inputtype}"
         
         rtype = narrow_types[inputtype]
+        if abbrev.startswith("vqmovun"):
+            rtype = "u" + rtype[1:]
 
         qtype = f"{neon_type2ctype[inputtype]}x{int(16/neon_type2size[inputtype]) }_t"
         dtype = f"{neon_type2ctype[rtype]}x{int(8/neon_type2size[rtype]) }_t"
 
         
-        args = [(qtype + " const&", "a0"), (qtype + " const&", "a1")]
+        args = [(arg(qtype), f"a{i}") for i in range(nargs) ]
 
         fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
 
@@ -160,39 +175,205 @@ def narrow128_op(abbrev, inputtypes, nargs):
         qtype = f"{neon_type2ctype[inputtype]}x{int(16/neon_type2size[inputtype]) }_t"
 
         rtype = narrow_types[inputtype]
+        if abbrev.startswith("vqmovun"):
+            rtype = "u" + rtype[1:]
 
         rdtype = f"{neon_type2ctype[rtype]}x{int(8/neon_type2size[rtype]) }_t"
         rqtype = f"{neon_type2ctype[rtype]}x{int(16/neon_type2size[rtype]) }_t"
 
         
-        args = [(rdtype + " const&", "a0"), (qtype + " const&", "a1"), (qtype + " const&", "a2")]
+        args = [(arg(rdtype), "a0")] + [(arg(qtype), f"a{i + 1}") for i in range(nargs) ]
 
         fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
 
         arglist = ", ".join([f"{an}" for at, an in args])
         print(f"inline {rqtype} {fname}({fn_arglist}) {{ return neon::{f}({arglist}); }}")
 
+def widening_acc64_op(abbrev, inputtypes, nargs):
+    # vmlal: wide accumulator plus two d-register operands
+    for inputtype in inputtypes:
+        fname = f"{abbrev}_{inputtype}"
+        qtype = vtype(long_types[inputtype], 16)
+        dtype = vtype(inputtype, 8)
+        print(f"inline {qtype} {fname}({arg(qtype)} a0, {arg(dtype)} a1, {arg(dtype)} a2) {{ return neon::{f}(a0, a1, a2); }}")
+
+def widening_acc128_op(abbrev, inputtypes, nargs):
+    for inputtype in inputtypes:
+        fname = f"{abbrev}_{inputtype}"
+        qtype = vtype(long_types[inputtype], 16)
+        dtype = vtype(inputtype, 16)
+        print(f"inline {qtype} {fname}({arg(qtype)} a0, {arg(dtype)} a1, {arg(dtype)} a2) {{ return neon::{f}(a0, a1, a2); }}")
+
+def dup_api(abbrev, inputtypes, nargs):
+    # vdup_n / vdup_lane / vdup_laneq; the lane ones are macros like in
+    # arm_neon.h so the lane stays a constant expression
+    kind = abbrev.split("_")[1]
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            rtype = vtype(inputtype, size)
+            if kind == "n":
+                print(f"inline {rtype} {fname}({neon_type2ctype[inputtype]}_t a0) {{ return neon::vdup_n<{rtype}>(a0); }}")
+            else:
+                stype = vtype(inputtype, 16 if kind == "laneq" else 8)
+                print(f"#define {fname}(a0, lane) neon::vdup_lane<lane, {rtype}>({stype}(a0))")
+                immediates[fname] = (rtype, [stype], "lane", f"vdup_lane<lane, {rtype}>(a0)", lane_range(stype))
+
+def lane_api(abbrev, inputtypes, nargs):
+    # vmul_n, vmla_lane, vfma_laneq, ...: the last operand is a scalar or a
+    # lane of a d (_lane) or q (_laneq) register
+    op, kind = abbrev.rsplit("_", 1)
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            args = [vt] * (nargs - 1)
+            fn = f"{op}_lane" if kind.startswith("lane") else f"{op}_n"
+            emit_lane_op(fname, fn, vt, args, inputtype, kind)
+
+def widening_lane_api(abbrev, inputtypes, nargs):
+    # vmull_n, vmlal_high_lane, ...: nargs counts the wide accumulator
+    op, kind = abbrev.rsplit("_", 1)
+    for inputtype in inputtypes:
+        fname = f"{abbrev}_{inputtype}"
+        wide = vtype(long_types[inputtype], 16)
+        narrow = vtype(inputtype, 16 if op.endswith("_high") else 8)
+        args = [wide, narrow] if nargs == 3 else [narrow]
+        fn = f"{op}_lane" if kind.startswith("lane") else f"{op}_n"
+        emit_lane_op(fname, fn, wide, args, inputtype, kind)
+
+def emit_lane_op(fname, fn, rtype, args, inputtype, kind):
+    names = [f"a{i}" for i in range(len(args) + 1)]
+    if kind == "n":
+        fn_arglist = ", ".join([f"{arg(at)} {an}" for at, an in zip(args, names)] + [f"{neon_type2ctype[inputtype]}_t {names[-1]}"])
+        print(f"inline {rtype} {fname}({fn_arglist}) {{ return neon::{fn}({', '.join(names)}); }}")
+    else:
+        stype = vtype(inputtype, 16 if kind == "laneq" else 8)
+        casts = ", ".join([f"{at}({an})" for at, an in zip(args + [stype], names)])
+        print(f"#define {fname}({', '.join(names)}, lane) neon::{fn}<lane>({casts})")
+        # spelled out as in neon.h, so a backend's own op and vdup_lane are picked
+        call = f"{fn[:-len('_lane')]}({', '.join(names[:-1])}, vdup_lane<lane, {args[-1]}>({names[-1]}))"
+        immediates[fname] = (rtype, args + [stype], "lane", call, lane_range(stype))
+
+# Forms taking a lane index or an immediate, by name: return type, register
+# operand types, the name of the constant, the call of the neon:: ops and the
+# lowest and highest constant. The dispatched api turns their macros into
+# templates on the constant.
+immediates = {}
+
+def lane_range(stype):
+    return 0, int(re.search(r"x(\d+)_t", stype).group(1)) - 1
+
+def immediate_range(abbrev, inputtype, size):
+    bits = 8 * neon_type2size[inputtype]
+    if abbrev == "vext":
+        return 0, size // neon_type2size[inputtype] - 1
+    if abbrev.endswith("rn_n"):
+        return 1, bits // 2
+    if abbrev in ["vshl_n", "vsli_n"]:
+        return 0, bits - 1
+    return 1, bits
+
+def shift_imm_api(abbrev, inputtypes, nargs):
+    # vshl_n, vsra_n, vsli_n, vext, ...: the shift (or lane) is an immediate,
+    # so like the lane ops these are macros; nargs counts the register operands
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            names = [f"a{i}" for i in range(nargs)]
+            casts = ", ".join([f"{vt}({an})" for an in names])
+            print(f"#define {fname}({', '.join(names)}, n) neon::{abbrev}<n>({casts})")
+            immediates[fname] = (vt, [vt] * nargs, "n", f"{abbrev}<n>({', '.join(names)})", immediate_range(abbrev, inputtype, size))
+
+def shift_narrow_api(abbrev, inputtypes, nargs):
+    # vshrn_n_s16: a q register in, a d register of the narrow type out
+    for inputtype in inputtypes:
+        fname = f"{abbrev}_{inputtype}"
+        print(f"#define {fname}(a0, n) neon::{abbrev}<n>({vtype(inputtype, 16)}(a0))")
+        immediates[fname] = (vtype(narrow_types[inputtype], 8), [vtype(inputtype, 16)], "n", f"{abbrev}<n>(a0)", immediate_range(abbrev, inputtype, 16))
+
+def shift_reg_api(abbrev, inputtypes, nargs):
+    # vshl_u16(a0, a1): the counts are a register of the signed type
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            ct = vtype("s" + inputtype[1:], size)
+            print(f"inline {vt} {fname}({arg(vt)} a0, {arg(ct)} a1) {{ return neon::{f}(a0, a1); }}")
+
+def permute_pair_api(abbrev, inputtypes, nargs):
+    # vzip_u8 / vzipq_u8 ...: both halves of the permute as an x2 tuple
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            print(f"inline {vt.replace('_t', 'x2_t')} {fname}({arg(vt)} a0, {arg(vt)} a1) {{ return neon::{f}(a0, a1); }}")
+
+def combine_api(abbrev, inputtypes, nargs):
+    # vcombine joins two d registers into a q register, vget_low/high split one
+    for inputtype in inputtypes:
+        fname = f"{abbrev}_{inputtype}"
+        dtype, qtype = vtype(inputtype, 8), vtype(inputtype, 16)
+        if abbrev == "vcombine":
+            print(f"inline {qtype} {fname}({arg(dtype)} a0, {arg(dtype)} a1) {{ return neon::{f}(a0, a1); }}")
+        else:
+            print(f"inline {dtype} {fname}({arg(qtype)} a) {{ return neon::{f}(a); }}")
+
+def table_api(abbrev, inputtypes, nargs):
+    # vtbl2 / vqtbx4 ...: the digit is the table register count; vq tables are
+    # q registers indexed by unsigned bytes, vtbl/vtbx have only d forms
+    count = int(abbrev[-1])
+    quad = abbrev.startswith("vq")
+    extension = abbrev[:-1].endswith("tbx")
+    for size in ([8, 16] if quad else [8]):
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            rtype = vtype(inputtype, size)
+            reg = vtype(inputtype, 16 if quad else 8)
+            table = reg if count == 1 else reg.replace("_t", f"x{count}_t")
+            itype = vtype("u8", size) if quad else rtype
+            if extension:
+                table_arg = f"neon::neon_tuple<{reg}, 1>{{ {{ a1 }} }}" if count == 1 else "a1"
+                print(f"inline {rtype} {fname}({arg(rtype)} a0, {arg(table)} a1, {arg(itype)} a2) {{ return neon::vtbx(a0, {table_arg}, a2); }}")
+            else:
+                table_arg = f"neon::neon_tuple<{reg}, 1>{{ {{ a0 }} }}" if count == 1 else "a0"
+                print(f"inline {rtype} {fname}({arg(table)} a0, {arg(itype)} a1) {{ return neon::vtbl({table_arg}, a1); }}")
+
 def horizontal_op(abbrev, inputtypes, nargs):
     for size in [8, 16]:
         for inputtype in inputtypes:
-            if inputtype == 'f16': 
-                # Not sure why f16 (vaddv case?)
-                continue
-            if size == 8 and inputtype in ['f16', 'f64']:
-                # We are in a float64x1 as input case, so it's a noop!
+            if size == 8 and neon_type2size[inputtype] == 8:
+                # a single-lane d register has nothing to reduce
                 continue
-            fname = f"{abbrev}q_{inputtype}" if size == 16 else f"{abbrev}_{inputtype}"
-
+            fname = qname(abbrev, size, inputtype)
             rtype = f"{neon_type2ctype[inputtype]}_t"
-            itype = f"{neon_type2ctype[inputtype]}x{int(size/neon_type2size[inputtype]) }_t"
+            print(f"inline {rtype} {fname}({arg(vtype(inputtype, size))} a) {{ return neon::{f}(a); }}")
 
-        
-            args = [(itype + " const&", "a")]
+def horizontal_long_op(abbrev, inputtypes, nargs):
+    # vaddlv: the sum comes back in the widened scalar type
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            rtype = f"{neon_type2ctype[long_types[inputtype]]}_t"
+            print(f"inline {rtype} {fname}({arg(vtype(inputtype, size))} a) {{ return neon::{f}(a); }}")
 
-            fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
+def pairwise_api(abbrev, inputtypes, nargs):
+    # vpadd, like the A64 permutes vzip1 ..., has no d form for 64-bit lanes
+    default_api(abbrev, [t for t in inputtypes if neon_type2size[t] < 8], nargs, sizes=[8])
+    default_api(abbrev, inputtypes, nargs, sizes=[16])
 
-            arglist = ", ".join([f"{an}" for at, an in args])
-            print(f"inline {rtype} {fname}({fn_arglist}) {{ return neon::{f}({arglist}); }}")
+def pairwise_long_op(abbrev, inputtypes, nargs):
+    # vpaddl / vpadal: half as many lanes of twice the width
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            wtype = vtype(long_types[inputtype], size)
+            itype = vtype(inputtype, size)
+            if nargs == 1:
+                print(f"inline {wtype} {fname}({arg(itype)} a) {{ return neon::{f}(a); }}")
+            else:
+                print(f"inline {wtype} {fname}({arg(wtype)} a0, {arg(itype)} a1) {{ return neon::{f}(a0, a1); }}")
 
 def bsl_api(abbrev, inputtypes, nargs):
     rep_type = {"f16":"u16", "f32": "u32", "f64": "u64"}
@@ -208,12 +389,11 @@ def bsl_api(abbrev, inputtypes, nargs):
 
             fname = f"{abbrev}q_{inputtype}" if size == 16 else f"{abbrev}_{inputtype}"
 
-            args = [(a_arg + " const&", "a0"), (bc_args + " const&", "a1"), (bc_args + " const&", "a2")]
+            args = [(arg(a_arg), "a0"), (arg(bc_args), "a1"), (arg(bc_args), "a2")]
 
             fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
-            templatetype = f"{neon_type2ctype[inputtype]}_t"
             arglist = ", ".join([f"{an}" for at, an in args])
-            print(f"inline {bc_args} {fname}({fn_arglist}) {{ return neon::{f}<{templatetype}>({arglist}); }}")
+            print(f"inline {bc_args} {fname}({fn_arglist}) {{ return neon::{f}({arglist}); }}")
 
 def compare_api(abbrev, inputtypes, nargs):
     rep_type = {"f16":"u16", "f32": "u32", "f64": "u64"}
@@ -230,9 +410,9 @@ def compare_api(abbrev, inputtypes, nargs):
             arg_type = f"{neon_type2ctype[inputtype]}x{int(size/neon_type2size[inputtype]) }_t"
             fname = f"{abbrev}q_{inputtype}" if size == 16 else f"{abbrev}_{inputtype}"
             if nargs > 1:
-                args = [(arg_type + " const&", f"a{i}") for i in range(nargs) ]
+                args = [(arg(arg_type), f"a{i}") for i in range(nargs) ]
             else:
-                args = [(arg_type + " const&", "a")]
+                args = [(arg(arg_type), "a")]
             fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
             templatetype = f"{neon_type2ctype[inputtype]}_t"
             arglist = ", ".join([f"{an}" for at, an in args])
@@ -248,14 +428,132 @@ def cvt_floats(abbrev, inputtypes, nargs):
 
                 fname = f"{abbrev}_{rtype}_{inputtype}" if size == 8 else f"{abbrev}q_{rtype}_{inputtype}"
             
-                args = [(arg_type + " const&", "a")]
+                args = [(arg(arg_type), "a")]
                 fn_arglist = ", ".join([f"{at} {an}" for at, an in args])
                 templatetype = f"{neon_type2ctype[rtype]}_t"
                 arglist = ", ".join([f"{an}" for at, an in args])
                 print(f"inline {r_type} {fname}({fn_arglist}) {{ return neon::{f}<{templatetype}>({arglist}); }}")
 
 
+def cvt_width_api(abbrev, inputtypes, nargs):
+    # vcvt_long emits vcvt_f32_f16 / vcvt_high_f32_f16, vcvt_narrow emits
+    # vcvt_f16_f32 / vcvt_high_f16_f32
+    wide_types = {"f16": "f32", "f32": "f64"}
+    for narrow in inputtypes:
+        wide = wide_types[narrow]
+        if abbrev == "vcvt_long":
+            print(f"inline {vtype(wide, 16)} vcvt_{wide}_{narrow}({arg(vtype(narrow, 8))} a) {{ return neon::{f}(a); }}")
+            print(f"inline {vtype(wide, 16)} vcvt_high_{wide}_{narrow}({arg(vtype(narrow, 16))} a) {{ return neon::{f}_high(a); }}")
+        else:
+            print(f"inline {vtype(narrow, 8)} vcvt_{narrow}_{wide}({arg(vtype(wide, 16))} a) {{ return neon::{f}(a); }}")
+            print(f"inline {vtype(narrow, 16)} vcvt_high_{narrow}_{wide}({arg(vtype(narrow, 8))} a0, {arg(vtype(wide, 16))} a1) {{ return neon::{f}_high(a0, a1); }}")
+
+def vtype(inputtype, size):
+    return f"{neon_type2ctype[inputtype]}x{int(size/neon_type2size[inputtype]) }_t"
+
+def qname(abbrev, size, inputtype):
+    # vld1_dup -> vld1_dup_u8 / vld1q_dup_u8
+    op, _, suffix = abbrev.partition("_")
+    q = "q" if size == 16 else ""
+    return f"{op}{q}_{suffix}_{inputtype}" if suffix else f"{op}{q}_{inputtype}"
+
+def load_api(abbrev, inputtypes, nargs):
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            rtype = vtype(inputtype, size)
+            ptype = f"{neon_type2ctype[inputtype]}_t const*"
+            print(f"inline {rtype} {fname}({ptype} a0) {{ return neon::{f}<{rtype}>(a0); }}")
+
+def load_lane_api(abbrev, inputtypes, nargs):
+    # the lane is a constant like for vdup_lane, so these are macros too
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            rtype = vtype(inputtype, size)
+            ptype = f"{neon_type2ctype[inputtype]}_t const*"
+            print(f"#define {fname}(a0, a1, lane) neon::{f}<lane>(a0, {rtype}(a1))")
+            immediates[fname] = (rtype, [ptype, rtype], "lane", f"{f}<lane>(a0, a1)", lane_range(rtype))
+
+def load_multi_api(abbrev, inputtypes, nargs):
+    # vld1_x2 -> vld1_u8_x2 / vld1q_u8_x2; nargs is the register count
+    op = abbrev.split("_")[0]
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = f"{op}q_{inputtype}_x{nargs}" if size == 16 else f"{op}_{inputtype}_x{nargs}"
+            vt = vtype(inputtype, size)
+            rtype = vt.replace("_t", f"x{nargs}_t")
+            ptype = f"{neon_type2ctype[inputtype]}_t const*"
+            print(f"inline {rtype} {fname}({ptype} a0) {{ return neon::{op}_x<{vt}, {nargs}>(a0); }}")
+
+def store_api(abbrev, inputtypes, nargs):
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            ptype = f"{neon_type2ctype[inputtype]}_t*"
+            print(f"inline void {fname}({ptype} a0, {arg(vt)} a1) {{ neon::{f}(a0, a1); }}")
+
+def store_lane_api(abbrev, inputtypes, nargs):
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            ptype = f"{neon_type2ctype[inputtype]}_t*"
+            print(f"#define {fname}(a0, a1, lane) neon::{f}<lane>(a0, {vt}(a1))")
+            immediates[fname] = ("void", [ptype, vt], "lane", f"{f}<lane>(a0, a1)", lane_range(vt))
+
+def store_multi_api(abbrev, inputtypes, nargs):
+    op = abbrev.split("_")[0]
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = f"{op}q_{inputtype}_x{nargs}" if size == 16 else f"{op}_{inputtype}_x{nargs}"
+            vt = vtype(inputtype, size)
+            tt = vt.replace("_t", f"x{nargs}_t")
+            ptype = f"{neon_type2ctype[inputtype]}_t*"
+            print(f"inline void {fname}({ptype} a0, {arg(tt)} a1) {{ neon::{op}_x(a0, a1); }}")
+
+def struct_load_api(abbrev, inputtypes, nargs):
+    # vld3 / vld3_dup; nargs is the structure size
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            rtype = vt.replace("_t", f"x{nargs}_t")
+            fn = "vldn_dup" if abbrev.endswith("_dup") else "vldn"
+            ptype = f"{neon_type2ctype[inputtype]}_t const*"
+            print(f"inline {rtype} {fname}({ptype} a0) {{ return neon::{fn}<{vt}, {nargs}>(a0); }}")
+
+def struct_load_lane_api(abbrev, inputtypes, nargs):
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            tt = vt.replace("_t", f"x{nargs}_t")
+            ptype = f"{neon_type2ctype[inputtype]}_t const*"
+            print(f"#define {fname}(a0, a1, lane) neon::vldn_lane<lane>(a0, {tt}(a1))")
+            immediates[fname] = (tt, [ptype, tt], "lane", "vldn_lane<lane>(a0, a1)", lane_range(vt))
+
+def struct_store_api(abbrev, inputtypes, nargs):
+    for size in [8, 16]:
+        for inputtype in inputtypes:
+            fname = qname(abbrev, size, inputtype)
+            vt = vtype(inputtype, size)
+            tt = vt.replace("_t", f"x{nargs}_t")
+            ptype = f"{neon_type2ctype[inputtype]}_t*"
+            if abbrev.endswith("_lane"):
+                print(f"#define {fname}(a0, a1, lane) neon::vstn_lane<lane>(a0, {tt}(a1))")
+                immediates[fname] = ("void", [ptype, tt], "lane", "vstn_lane<lane>(a0, a1)", lane_range(vt))
+            else:
+                print(f"inline void {fname}({ptype} a0, {arg(tt)} a1) {{ neon::vstn(a0, a1); }}")
+
+
 api = { "vabd": (default_api, neon_types, 2),  
+        "vaba": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 3),
+        "vabal": (widening_acc64_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 3),
+        "vabal_high": (widening_acc128_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 3),
+        "vabdl": (vaddl_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),
+        "vabdl_high": (vaddl_high_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),
         "vabs": (default_api, sint_neon_types + float_neon_types, 1),
         "vadd": (default_api, neon_types, 2),  
         "vaddl": (vaddl_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),  
@@ -264,11 +562,13 @@ api = { "vabd": (default_api, neon_types, 2),
         "vaddw_high": (widening128_op,  ["s8", "s16", "s32", "u8", "u16", "u32"], 2),  
         "vaddhn": (narrow64_op,  narrow_types.keys(), 2),  
         "vaddhn_high": (narrow128_op,  narrow_types.keys(), 2),  
-        "vaddv": (horizontal_op, neon_types, 1),
+        "vaddv": (horizontal_op, sint_neon_types + uint_neon_types + ["f32", "f64"], 1),
+        "vaddlv": (horizontal_long_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 1),
 
+        "vand": (default_api, sint_neon_types + uint_neon_types , 2),
         "vbic": (default_api, sint_neon_types + uint_neon_types , 2),
         "vbsl": (bsl_api, neon_types , 3),
-        #sha3 "vbcax": (default_api, sint_neon_types + uint_neon_types , 3),
+        "vbcax": (q_api, sint_neon_types + uint_neon_types , 3),
         #armv8.6-a+bf16 "vbfdot"
         #armv8.6-a+bf16 "vbfdot_lane"
         #armv8.6-a+bf16 "vbfmmlatq"
@@ -293,12 +593,298 @@ api = { "vabd": (default_api, neon_types, 2),
         "vcagt":  (compare_api, float_neon_types, 2),
         "vcalt":  (compare_api, float_neon_types, 2),
 
+        "vcombine": (combine_api, neon_types, 2),
+
         "vcvt": (cvt_floats, float_neon_types, 1),
+        "vcvt_long": (cvt_width_api, ["f16", "f32"], 1),
+        "vcvt_narrow": (cvt_width_api, ["f16", "f32"], 1),
+
+        "vdup_n": (dup_api, neon_types, 1),
+        "vdup_lane": (dup_api, neon_types, 1),
+        "vdup_laneq": (dup_api, neon_types, 1),
+
+        "veor": (default_api, sint_neon_types + uint_neon_types , 2),
+        "veor3": (q_api, sint_neon_types + uint_neon_types , 3),
+        "vext": (shift_imm_api, neon_types, 2),
+        "vfma": (default_api, ["f32", "f64"], 3),
+        "vfms": (default_api, ["f32", "f64"], 3),
+        "vfma_n": (lane_api, ["f32", "f64"], 3),
+        "vfma_lane": (lane_api, ["f32", "f64"], 3),
+        "vfma_laneq": (lane_api, ["f32", "f64"], 3),
+        "vfms_n": (lane_api, ["f32", "f64"], 3),
+        "vfms_lane": (lane_api, ["f32", "f64"], 3),
+        "vfms_laneq": (lane_api, ["f32", "f64"], 3),
+
+        "vget_high": (combine_api, neon_types, 1),
+        "vget_low": (combine_api, neon_types, 1),
+
+        "vhadd": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),
+        "vhsub": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),
+        "vrhadd": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),
+
+        "vld1": (load_api, neon_types, 1),
+        "vld1_dup": (load_api, neon_types, 1),
+        "vld1_lane": (load_lane_api, neon_types, 2),
+        "vld1_x2": (load_multi_api, neon_types, 2),
+        "vld1_x3": (load_multi_api, neon_types, 3),
+        "vld1_x4": (load_multi_api, neon_types, 4),
+
+        "vld2": (struct_load_api, neon_types, 2),
+        "vld2_dup": (struct_load_api, neon_types, 2),
+        "vld2_lane": (struct_load_lane_api, neon_types, 2),
+        "vld3": (struct_load_api, neon_types, 3),
+        "vld3_dup": (struct_load_api, neon_types, 3),
+        "vld3_lane": (struct_load_lane_api, neon_types, 3),
+        "vld4": (struct_load_api, neon_types, 4),
+        "vld4_dup": (struct_load_api, neon_types, 4),
+        "vld4_lane": (struct_load_lane_api, neon_types, 4),
+
+        "vmaxv": (horizontal_op, ["s8", "s16", "s32", "u8", "u16", "u32"] + float_neon_types, 1),
+        "vmaxnmv": (horizontal_op, float_neon_types, 1),
+        "vminv": (horizontal_op, ["s8", "s16", "s32", "u8", "u16", "u32"] + float_neon_types, 1),
+        "vminnmv": (horizontal_op, float_neon_types, 1),
+
+        "vmla": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32", "f32", "f64"], 3),
+        "vmlal": (widening_acc64_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 3),
+        "vmlal_high": (widening_acc128_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 3),
+        "vmls": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32", "f32", "f64"], 3),
+        "vmlsl": (widening_acc64_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 3),
+        "vmlsl_high": (widening_acc128_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 3),
+        "vmul": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32", "f32", "f64"], 2),
+        "vmull": (vaddl_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),
+        "vmull_high": (vaddl_high_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),
+
+        "vmla_n": (lane_api, ["s16", "s32", "u16", "u32", "f32"], 3),
+        "vmla_lane": (lane_api, ["s16", "s32", "u16", "u32", "f32"], 3),
+        "vmla_laneq": (lane_api, ["s16", "s32", "u16", "u32", "f32"], 3),
+        "vmls_n": (lane_api, ["s16", "s32", "u16", "u32", "f32"], 3),
+        "vmls_lane": (lane_api, ["s16", "s32", "u16", "u32", "f32"], 3),
+        "vmls_laneq": (lane_api, ["s16", "s32", "u16", "u32", "f32"], 3),
+        "vmul_n": (lane_api, ["s16", "s32", "u16", "u32", "f32", "f64"], 2),
+        "vmul_lane": (lane_api, ["s16", "s32", "u16", "u32", "f32", "f64"], 2),
+        "vmul_laneq": (lane_api, ["s16", "s32", "u16", "u32", "f32", "f64"], 2),
+        "vmlal_n": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlal_lane": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlal_laneq": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlal_high_n": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlal_high_lane": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlal_high_laneq": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlsl_n": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlsl_lane": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlsl_laneq": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlsl_high_n": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlsl_high_lane": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmlsl_high_laneq": (widening_lane_api, ["s16", "s32", "u16", "u32"], 3),
+        "vmull_n": (widening_lane_api, ["s16", "s32", "u16", "u32"], 2),
+        "vmull_lane": (widening_lane_api, ["s16", "s32", "u16", "u32"], 2),
+        "vmull_laneq": (widening_lane_api, ["s16", "s32", "u16", "u32"], 2),
+        "vmull_high_n": (widening_lane_api, ["s16", "s32", "u16", "u32"], 2),
+        "vmull_high_lane": (widening_lane_api, ["s16", "s32", "u16", "u32"], 2),
+        "vmull_high_laneq": (widening_lane_api, ["s16", "s32", "u16", "u32"], 2),
+
+        "vmovl": (vaddl_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 1),
+        "vmovl_high": (vaddl_high_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 1),
+        "vmovn": (narrow64_op, narrow_types.keys(), 1),
+        "vmovn_high": (narrow128_op, narrow_types.keys(), 1),
+        "vmvn": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32"], 1),
+        "vorn": (default_api, sint_neon_types + uint_neon_types , 2),
+        "vorr": (default_api, sint_neon_types + uint_neon_types , 2),
+
+        "vpadd": (pairwise_api, sint_neon_types + uint_neon_types + ["f32", "f64"], 2),
+        "vpaddl": (pairwise_long_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 1),
+        "vpadal": (pairwise_long_op, ["s8", "s16", "s32", "u8", "u16", "u32"], 2),
+
+        "vqabs": (default_api, sint_neon_types, 1),
+        "vqadd": (default_api, sint_neon_types + uint_neon_types, 2),
+        "vqdmulh": (default_api, ["s16", "s32"], 2),
+        "vqmovn": (narrow64_op, narrow_types.keys(), 1),
+        "vqmovn_high": (narrow128_op, narrow_types.keys(), 1),
+        "vqmovun": (narrow64_op, ["s16", "s32", "s64"], 1),
+        "vqmovun_high": (narrow128_op, ["s16", "s32", "s64"], 1),
+        "vqneg": (default_api, sint_neon_types, 1),
+        "vqrdmulh": (default_api, ["s16", "s32"], 2),
+        "vqsub": (default_api, sint_neon_types + uint_neon_types, 2),
+        "vqshl": (shift_reg_api, sint_neon_types + uint_neon_types, 2),
+        "vqshrn_n": (shift_narrow_api, narrow_types.keys(), 1),
+        "vqrshrn_n": (shift_narrow_api, narrow_types.keys(), 1),
+
+        "vrev16": (default_api, ["s8", "u8"], 1),
+        "vrev32": (default_api, ["s8", "s16", "u8", "u16"], 1),
+        "vrev64": (default_api, ["s8", "s16", "s32", "u8", "u16", "u32", "f16", "f32"], 1),
+
+        "vrshl": (shift_reg_api, sint_neon_types + uint_neon_types, 2),
+        "vrshr_n": (shift_imm_api, sint_neon_types + uint_neon_types, 1),
+        "vrshrn_n": (shift_narrow_api, narrow_types.keys(), 1),
+        "vrsra_n": (shift_imm_api, sint_neon_types + uint_neon_types, 2),
+
+        "vshl": (shift_reg_api, sint_neon_types + uint_neon_types, 2),
+        "vshl_n": (shift_imm_api, sint_neon_types + uint_neon_types, 1),
+        "vshr_n": (shift_imm_api, sint_neon_types + uint_neon_types, 1),
+        "vshrn_n": (shift_narrow_api, narrow_types.keys(), 1),
+        "vsli_n": (shift_imm_api, sint_neon_types + uint_neon_types, 2),
+        "vsra_n": (shift_imm_api, sint_neon_types + uint_neon_types, 2),
+        "vsri_n": (shift_imm_api, sint_neon_types + uint_neon_types, 2),
+
+        "vst1": (store_api, neon_types, 2),
+        "vst1_lane": (store_lane_api, neon_types, 2),
+        "vst1_x2": (store_multi_api, neon_types, 2),
+        "vst1_x3": (store_multi_api, neon_types, 3),
+        "vst1_x4": (store_multi_api, neon_types, 4),
+        "vst2": (struct_store_api, neon_types, 2),
+        "vst2_lane": (struct_store_api, neon_types, 2),
+        "vst3": (struct_store_api, neon_types, 3),
+        "vst3_lane": (struct_store_api, neon_types, 3),
+        "vst4": (struct_store_api, neon_types, 4),
+        "vst4_lane": (struct_store_api, neon_types, 4),
+
+        "vtbl1": (table_api, ["s8", "u8"], 2),
+        "vtbl2": (table_api, ["s8", "u8"], 2),
+        "vtbl3": (table_api, ["s8", "u8"], 2),
+        "vtbl4": (table_api, ["s8", "u8"], 2),
+        "vtbx1": (table_api, ["s8", "u8"], 2),
+        "vtbx2": (table_api, ["s8", "u8"], 2),
+        "vtbx3": (table_api, ["s8", "u8"], 2),
+        "vtbx4": (table_api, ["s8", "u8"], 2),
+        "vqtbl1": (table_api, ["s8", "u8"], 2),
+        "vqtbl2": (table_api, ["s8", "u8"], 2),
+        "vqtbl3": (table_api, ["s8", "u8"], 2),
+        "vqtbl4": (table_api, ["s8", "u8"], 2),
+        "vqtbx1": (table_api, ["s8", "u8"], 2),
+        "vqtbx2": (table_api, ["s8", "u8"], 2),
+        "vqtbx3": (table_api, ["s8", "u8"], 2),
+        "vqtbx4": (table_api, ["s8", "u8"], 2),
+
+        "vtrn": (permute_pair_api, ["s8", "s16", "s32", "u8", "u16", "u32", "f16", "f32"], 2),
+        "vtrn1": (pairwise_api, neon_types, 2),
+        "vtrn2": (pairwise_api, neon_types, 2),
+        "vuzp": (permute_pair_api, ["s8", "s16", "s32", "u8", "u16", "u32", "f16", "f32"], 2),
+        "vuzp1": (pairwise_api, neon_types, 2),
+        "vuzp2": (pairwise_api, neon_types, 2),
+        "vzip": (permute_pair_api, ["s8", "s16", "s32", "u8", "u16", "u32", "f16", "f32"], 2),
+        "vzip1": (pairwise_api, neon_types, 2),
+        "vzip2": (pairwise_api, neon_types, 2),
 
 }
 
+# ARM cost model for the profiler (neon_profile.h). Per class of instruction:
+# the pipe its throughput counts against, then per core the latency and
+# reciprocal throughput in cycles of the D form and of the Q form. The numbers
+# are rounded from the Arm software optimization guides; Neoverse N1 is the
+# A76 pipeline. Sequences (vmla_f32 is fmul + fadd, veor3 and vbcax are two
+# instructions without SHA3, vzip is zip1 + zip2) are costed as the sequence;
+# vget_low is no instruction at all.
+cost_cores = ["cortex_a76", "neoverse_n1", "neoverse_v1"]
+cost_pipes = ["asimd", "load", "store"]
+
+cost_classes = {
+    #                 pipe   cortex_a76            neoverse_n1           neoverse_v1
+    "alu":            (0, [(2, .5, 2, .5),     (2, .5, 2, .5),     (2, .25, 2, .25)]),
+    "alu_complex":    (0, [(4, 1, 4, 1),       (4, 1, 4, 1),       (4, .5, 4, .5)]),
+    "alu_pair":       (0, [(2, 1, 2, 1),       (2, 1, 2, 1),       (2, .5, 2, .5)]),
+    "none":           (0, [(0, 0, 0, 0),       (0, 0, 0, 0),       (0, 0, 0, 0)]),
+    "dup_gpr":        (0, [(3, 1, 3, 1),       (3, 1, 3, 1),       (3, .5, 3, .5)]),
+    "reduce":         (0, [(3, 1, 5, 1),       (3, 1, 5, 1),       (3, 1, 4, 1)]),
+    "eor3":           (0, [(4, 1, 4, 1),       (4, 1, 4, 1),       (2, .5, 2, .5)]),
+    "int_mul":        (0, [(4, 1, 4, 1),       (4, 1, 4, 1),       (4, .5, 4, .5)]),
+    "fp_alu":         (0, [(2, .5, 2, .5),     (2, .5, 2, .5),     (2, .25, 2, .25)]),
+    "fp_reduce":      (0, [(4, 1, 4, 1),       (4, 1, 4, 1),       (4, .5, 4, .5)]),
+    "fp_mul":         (0, [(3, .5, 3, .5),     (3, .5, 3, .5),     (3, .25, 3, .25)]),
+    "fp_mla":         (0, [(5, 1, 5, 1),       (5, 1, 5, 1),       (5, .5, 5, .5)]),
+    "fma":            (0, [(4, .5, 4, .5),     (4, .5, 4, .5),     (4, .25, 4, .25)]),
+    "cvt":            (0, [(3, .5, 4, 1),      (3, .5, 4, 1),      (3, .5, 3, .5)]),
+    "cvt_width":      (0, [(4, 1, 4, 1),       (4, 1, 4, 1),       (3, .5, 3, .5)]),
+    "tbl1":           (0, [(2, .5, 2, .5),     (2, .5, 2, .5),     (2, .5, 2, .5)]),
+    "tbl2":           (0, [(4, 1, 4, 1),       (4, 1, 4, 1),       (4, 1, 4, 1)]),
+    "tbl3":           (0, [(6, 1.5, 6, 1.5),   (6, 1.5, 6, 1.5),   (6, 1.5, 6, 1.5)]),
+    "tbl4":           (0, [(8, 2, 8, 2),       (8, 2, 8, 2),       (8, 2, 8, 2)]),
+    "ld1":            (1, [(5, .5, 5, .5),     (5, .5, 5, .5),     (6, .33, 6, .33)]),
+    "ld1_x2":         (1, [(5, 1, 5, 1),       (5, 1, 5, 1),       (6, .67, 6, .67)]),
+    "ld1_x3":         (1, [(6, 1.5, 6, 1.5),   (6, 1.5, 6, 1.5),   (7, 1, 7, 1)]),
+    "ld1_x4":         (1, [(6, 2, 6, 2),       (6, 2, 6, 2),       (7, 1.33, 7, 1.33)]),
+    "ld1_single":     (1, [(8, .5, 8, .5),     (8, .5, 8, .5),     (8, .33, 8, .33)]),
+    "ld2":            (1, [(8, 1, 8, 2),       (8, 1, 8, 2),       (8, .67, 8, 1)]),
+    "ld3":            (1, [(8, 1.5, 9, 3),     (8, 1.5, 9, 3),     (8, 1, 9, 2)]),
+    "ld4":            (1, [(8, 2, 9, 4),       (8, 2, 9, 4),       (8, 1.33, 9, 2.67)]),
+    "ld2_single":     (1, [(8, 1, 8, 1),       (8, 1, 8, 1),       (8, .67, 8, .67)]),
+    "ld3_single":     (1, [(8, 1.5, 8, 1.5),   (8, 1.5, 8, 1.5),   (8, 1, 8, 1)]),
+    "ld4_single":     (1, [(8, 2, 8, 2),       (8, 2, 8, 2),       (8, 1.33, 8, 1.33)]),
+    "st1":            (2, [(2, 1, 2, 1),       (2, 1, 2, 1),       (2, .5, 2, .5)]),
+    "st1_x2":         (2, [(2, 1, 2, 2),       (2, 1, 2, 2),       (2, .5, 2, 1)]),
+    "st1_x3":         (2, [(2, 2, 2, 3),       (2, 2, 2, 3),       (2, 1, 2, 1.5)]),
+    "st1_x4":         (2, [(2, 2, 2, 4),       (2, 2, 2, 4),       (2, 1, 2, 2)]),
+    "st2":            (2, [(4, 1, 4, 2),       (4, 1, 4, 2),       (4, .5, 4, 1)]),
+    "st3":            (2, [(5, 2, 6, 3),       (5, 2, 6, 3),       (5, 1, 6, 1.5)]),
+    "st4":            (2, [(5, 2, 6, 4),       (5, 2, 6, 4),       (5, 1, 6, 2)]),
+    "st2_single":     (2, [(4, 1, 4, 1),       (4, 1, 4, 1),       (4, .5, 4, .5)]),
+    "st3_single":     (2, [(5, 2, 5, 2),       (5, 2, 5, 2),       (5, 1, 5, 1)]),
+    "st4_single":     (2, [(5, 2, 5, 2),       (5, 2, 5, 2),       (5, 1, 5, 1)]),
+}
 
-print("#include \"neon.h\"")
+# api entry -> cost class, or (integer class, float class)
+cost_families = {
+        "vabd": ("alu", "fp_alu"), "vabs": "alu", "vadd": ("alu", "fp_alu"),
+        "vaba": "alu_complex", "vabal": "alu_complex", "vabal_high": "alu_complex", "vabdl": "alu", "vabdl_high": "alu",
+        "vaddl": "alu", "vaddl_high": "alu", "vaddw": "alu", "vaddw_high": "alu",
+        "vaddhn": "alu_complex", "vaddhn_high": "alu_complex",
+        "vaddv": ("reduce", "fp_reduce"), "vaddlv": "reduce",
+        "vand": "alu", "vbic": "alu", "vbsl": "alu", "vbcax": "eor3",
+        "vceq": ("alu", "fp_alu"), "vceqz": ("alu", "fp_alu"), "vcge": ("alu", "fp_alu"), "vcgez": ("alu", "fp_alu"),
+        "vcle": ("alu", "fp_alu"), "vclez": ("alu", "fp_alu"), "vcgt": ("alu", "fp_alu"), "vcgtz": ("alu", "fp_alu"),
+        "vclt": ("alu", "fp_alu"), "vcltz": ("alu", "fp_alu"),
+        "vcage": "fp_alu", "vcale": "fp_alu", "vcagt": "fp_alu", "vcalt": "fp_alu",
+        "vcombine": "alu",
+        "vcvt": "cvt", "vcvt_long": "cvt_width", "vcvt_narrow": "cvt_width",
+        "vdup_n": ("dup_gpr", "alu"), "vdup_lane": "alu", "vdup_laneq": "alu",
+        "veor": "alu", "veor3": "eor3", "vext": "alu",
+        "vfma": "fma", "vfms": "fma", "vfma_n": "fma", "vfma_lane": "fma", "vfma_laneq": "fma",
+        "vfms_n": "fma", "vfms_lane": "fma", "vfms_laneq": "fma",
+        "vget_high": "alu", "vget_low": "none",
+        "vhadd": "alu", "vhsub": "alu", "vrhadd": "alu",
+        "vld1": "ld1", "vld1_dup": "ld1_single", "vld1_lane": "ld1_single",
+        "vld1_x2": "ld1_x2", "vld1_x3": "ld1_x3", "vld1_x4": "ld1_x4",
+        "vld2": "ld2", "vld2_dup": "ld2_single", "vld2_lane": "ld2_single",
+        "vld3": "ld3", "vld3_dup": "ld3_single", "vld3_lane": "ld3_single",
+        "vld4": "ld4", "vld4_dup": "ld4_single", "vld4_lane": "ld4_single",
+        "vmaxv": ("reduce", "fp_reduce"), "vmaxnmv": "fp_reduce", "vminv": ("reduce", "fp_reduce"), "vminnmv": "fp_reduce",
+        "vmla": ("int_mul", "fp_mla"), "vmls": ("int_mul", "fp_mla"), "vmul": ("int_mul", "fp_mul"),
+        "vmla_n": ("int_mul", "fp_mla"), "vmla_lane": ("int_mul", "fp_mla"), "vmla_laneq": ("int_mul", "fp_mla"),
+        "vmls_n": ("int_mul", "fp_mla"), "vmls_lane": ("int_mul", "fp_mla"), "vmls_laneq": ("int_mul", "fp_mla"),
+        "vmul_n": ("int_mul", "fp_mul"), "vmul_lane": ("int_mul", "fp_mul"), "vmul_laneq": ("int_mul", "fp_mul"),
+        "vmlal": "int_mul", "vmlal_high": "int_mul", "vmlsl": "int_mul", "vmlsl_high": "int_mul",
+        "vmull": "int_mul", "vmull_high": "int_mul",
+        "vmlal_n": "int_mul", "vmlal_lane": "int_mul", "vmlal_laneq": "int_mul",
+        "vmlal_high_n": "int_mul", "vmlal_high_lane": "int_mul", "vmlal_high_laneq": "int_mul",
+        "vmlsl_n": "int_mul", "vmlsl_lane": "int_mul", "vmlsl_laneq": "int_mul",
+        "vmlsl_high_n": "int_mul", "vmlsl_high_lane": "int_mul", "vmlsl_high_laneq": "int_mul",
+        "vmull_n": "int_mul", "vmull_lane": "int_mul", "vmull_laneq": "int_mul",
+        "vmull_high_n": "int_mul", "vmull_high_lane": "int_mul", "vmull_high_laneq": "int_mul",
+        "vmovl": "alu", "vmovl_high": "alu", "vmovn": "alu", "vmovn_high": "alu",
+        "vmvn": "alu", "vorn": "alu", "vorr": "alu",
+        "vpadd": ("alu", "fp_alu"), "vpaddl": "alu", "vpadal": "alu_complex",
+        "vqabs": "alu", "vqadd": "alu", "vqneg": "alu", "vqsub": "alu",
+        "vqdmulh": "int_mul", "vqrdmulh": "int_mul",
+        "vqmovn": "alu_complex", "vqmovn_high": "alu_complex", "vqmovun": "alu_complex", "vqmovun_high": "alu_complex",
+        "vqshl": "alu_complex", "vqshrn_n": "alu_complex", "vqrshrn_n": "alu_complex",
+        "vrev16": "alu", "vrev32": "alu", "vrev64": "alu",
+        "vrshl": "alu_complex", "vrshr_n": "alu_complex", "vrshrn_n": "alu_complex", "vrsra_n": "alu_complex",
+        "vshl": "alu", "vshl_n": "alu", "vshr_n": "alu", "vshrn_n": "alu_complex",
+        "vsli_n": "alu", "vsra_n": "alu_complex", "vsri_n": "alu",
+        "vst1": "st1", "vst1_lane": "st1", "vst1_x2": "st1_x2", "vst1_x3": "st1_x3", "vst1_x4": "st1_x4",
+        "vst2": "st2", "vst2_lane": "st2_single", "vst3": "st3", "vst3_lane": "st3_single",
+        "vst4": "st4", "vst4_lane": "st4_single",
+        # vtbl2/vtbx2 tables are one Q register on AArch64, vtbl3/4 two
+        "vtbl1": "tbl1", "vtbl2": "tbl1", "vtbl3": "tbl2", "vtbl4": "tbl2",
+        "vtbx1": "tbl1", "vtbx2": "tbl1", "vtbx3": "tbl2", "vtbx4": "tbl2",
+        "vqtbl1": "tbl1", "vqtbl2": "tbl2", "vqtbl3": "tbl3", "vqtbl4": "tbl4",
+        "vqtbx1": "tbl1", "vqtbx2": "tbl2", "vqtbx3": "tbl3", "vqtbx4": "tbl4",
+        "vtrn": "alu_pair", "vtrn1": "alu", "vtrn2": "alu",
+        "vuzp": "alu_pair", "vuzp1": "alu", "vuzp2": "alu",
+        "vzip": "alu_pair", "vzip1": "alu", "vzip2": "alu",
+}
+
+
+lines = []
+families = {} # wrapper name -> api entry
 for f in api:
     fn, t, n = api[f]
 
@@ -326,7 +912,295 @@ for f in api:
     #        #print (arglist)
     #        #print (ftype, rett)
     #        print(f"inline {rettype} {fname}({fn_arglist}) {{ return neon::{f}({arglist}); }}")
+    sys.stdout = out = io.StringIO()
     fn(f, t, n)
-
-
-         
\ No newline at end of file
+    sys.stdout = sys.__stdout__
+    for l in out.getvalue().splitlines():
+        lines.append(l)
+        m = re.match(r"(?:inline \S+|#define) (\w+)\(", l)
+        if m:
+            families[m.group(1)] = f
+
+# FPCR fixups, see neon::fpcr_result in neon.h: float arithmetic takes DN and
+# FZ16 on its result and FZ16 on its half-precision operands, compares FZ16 on
+# their operands, float conversions DN on their result.
+fpcr_arithmetic = {"vabd", "vadd", "vaddv", "vfma", "vfms", "vfma_n", "vfms_n", "vmaxv", "vmaxnmv", "vminv", "vminnmv",
+                   "vmla", "vmls", "vmul", "vmla_n", "vmls_n", "vmul_n", "vpadd"}
+fpcr_compare = {"vceq", "vceqz", "vcge", "vcgez", "vcle", "vclez", "vcgt", "vcgtz", "vclt", "vcltz",
+                "vcage", "vcale", "vcagt", "vcalt"}
+fpcr_convert = {"vcvt_long", "vcvt_narrow"}
+
+def fpcr_fixed(l):
+    m = re.match(r"(inline (\S+) (\w+)\((.*?)\) \{ return )(.*); \}$", l)
+    if not m:
+        return l
+    head, rtype, name, params, call = m.groups()
+    family = families[name]
+    if family in fpcr_arithmetic | fpcr_compare:
+        for ptype, pname in (p.rsplit(" ", 1) for p in params.split(", ")):
+            if "float16x" in ptype:
+                call = re.sub(rf"\b{pname}\b", f"neon::fpcr_operand({pname})", call)
+    if rtype.startswith("float") and family in fpcr_arithmetic:
+        call = f"neon::fpcr_result({call})"
+    elif rtype.startswith("float") and family in fpcr_convert:
+        call = f"neon::fpcr_convert{'_high' if family == 'vcvt_narrow' and '_high_' in name else ''}({call})"
+    return f"{head}{call}; }}"
+
+lines = [fpcr_fixed(l) for l in lines]
+wrappers = [l for l in lines if l.startswith("inline ")]
+macros = [l for l in lines if not l.startswith("inline ")]
+
+def immediate_wrapper(name, body):
+    # a lane or immediate form as a template on its constant
+    rtype, args, constant, call, _ = immediates[name]
+    params = ", ".join(f"{t if t.endswith('*') else arg(t)} a{i}" for i, t in enumerate(args))
+    names = ", ".join(f"a{i}" for i in range(len(args)))
+    return f"template <int {constant}> inline {rtype} {name}({params}) {{ {body(constant, call, names)} }}"
+
+def immediate_macro(name, target):
+    # its macro, calling the template in target
+    _, args, constant, _, _ = immediates[name]
+    names = ", ".join(f"a{i}" for i in range(len(args)))
+    return f"#define {name}({names}, {constant}) {target}{name}<{constant}>({names})"
+
+# The lane and immediate forms are profiled and traced like the wrappers, so
+# their macros call templates running what the macro did.
+templates = {}
+for m in macros:
+    name, body = re.match(r"#define (\w+)\(.*?\) (.*)$", m).groups()
+    ret = "" if immediates[name][0] == "void" else "return "
+    templates[name] = immediate_wrapper(name, lambda constant, call, names: f"{ret}{body};")
+
+signature = r"(?:template <int (\w+)> )?inline (\S+) \(?(\w+)\)?\((.*?)\) \{"
+functions = wrappers + list(templates.values())
+function_names = [re.match(signature, w).group(3) for w in functions]
+function_ids = {name: i for i, name in enumerate(function_names)}
+
+def profiled(w):
+    # NEON_PROFILE_CALL is empty unless NEON_PROFILE is defined, see neon_profile.h
+    name = re.match(signature, w).group(3)
+    return w.replace("{ ", f"{{ NEON_PROFILE_CALL({function_ids[name]}) ", 1)
+
+def trace_memory(name, w):
+    # bytes a load reads or a store writes, recorded with the call
+    m = re.match(r"v(ld|st)(\d)", families[name])
+    if not m:
+        return 0
+    if re.search(r"_(lane|dup)$", families[name]):
+        return int(m.group(2)) * neon_type2size[re.findall(r"_([suf]\d+)", name)[-1]]
+    _, rtype, _, params = re.match(signature, w).groups()
+    vtype = rtype if m.group(1) == "ld" else params.rsplit(", ", 1)[1]
+    bits, lanes, count = re.search(r"(?:int|float)(\d+)x(\d+)(?:x(\d))?", vtype).groups()
+    return int(bits) * int(lanes) // 8 * int(count or 1)
+
+def trace_records(name, w):
+    # records a call of a wrapper takes in the trace: its operands, the memory
+    # behind its pointer and its result in 16-byte slots, four to a record
+    _, rtype, _, params = re.match(signature, w).groups()
+    def slots(ctype):
+        if ctype.endswith("*"):
+            return (trace_memory(name, w) + 15) // 16
+        m = re.search(r"(?:int|float)(\d+)x(\d+)(?:x(\d))?_t", ctype)
+        if m:
+            return int(m.group(1)) * int(m.group(2)) * int(m.group(3) or 1) // 128 or 1
+        return 0 if ctype == "void" else 1
+    n = slots(rtype) + sum(slots(p.rsplit(" ", 1)[0]) for p in params.split(", "))
+    return max((n + 3) // 4, 1)
+
+def instrumented(w):
+    # NEON_TRACE_CALL is the bare call unless NEON_TRACE is defined, see neon_trace.h
+    constant, _, name, params = re.match(signature, w).groups()
+    head, ret, call = re.match(r"(.*?\) \{ )(return )?(.*); \}$", w).groups()
+    args = ", ".join(p.rsplit(" ", 1)[1] for p in params.split(", "))
+    lane = neon_types.index(re.findall(r"_([suf]\d+)", name)[-1])
+    trace = f"NEON_TRACE_CALL({function_ids[name]}, {lane}, {trace_memory(name, w)}, {constant or 0}, ({args}), {call})"
+    return profiled(f"{head}{ret or ''}{trace}; }}")
+
+def function_cost(w):
+    # pipe and per core (latency, reciprocal throughput) of a wrapper; Q form
+    # when any of its vectors is 128 bits
+    name = re.match(signature, w).group(3)
+    if families[name] not in cost_families:
+        sys.exit(f"api.py: no ARM cost class for {families[name]}")
+    c = cost_families[families[name]]
+    if isinstance(c, tuple):
+        c = c[1] if re.search(r"_f\d+$", name) else c[0]
+    pipe, cores = cost_classes[c]
+    q = any(int(bits) * int(n) == 128 for bits, n in re.findall(r"(?:int|float)(\d+)x(\d+)", w))
+    return pipe, [(lq, tq) if q else (ld, td) for ld, td, lq, tq in cores]
+
+def print_instrumentation():
+    # the hash identifies the function ids in traces, see neon_trace.h
+    api_hash = 0xcbf29ce484222325
+    for c in "\n".join(function_names).encode():
+        api_hash = ((api_hash ^ c) * 0x100000001b3) & 0xffffffffffffffff
+    print(f"#define NEON_API_HASH 0x{api_hash:016x}ull")
+    print(f"#define NEON_TRACE_CALL_RECORDS {max(trace_records(n, w) for n, w in zip(function_names, functions))}")
+
+    costs = [function_cost(w) for w in functions]
+    print("#if defined(NEON_PROFILE)")
+    print(f"#define NEON_PROFILE_FUNCTIONS {len(function_names)}")
+    print(f"#define NEON_PROFILE_CORES {len(cost_cores)}")
+    print("namespace neon { namespace profile {")
+    for table, values in [("function_names", function_names), ("function_families", [families[n] for n in function_names]),
+                          ("core_names", cost_cores), ("pipe_names", cost_pipes)]:
+        print(f"static const char* const {table}[] = {{")
+        for i in range(0, len(values), 8):
+            print("\t" + " ".join(f"\"{v}\"," for v in values[i:i + 8]))
+        print("};")
+    print("static const unsigned char function_pipes[] = {")
+    for i in range(0, len(costs), 32):
+        print("\t" + " ".join(f"{c[0]}," for c in costs[i:i + 32]))
+    print("};")
+    for table, field in [("function_latency", 0), ("function_throughput", 1)]:
+        print(f"static const float {table}[NEON_PROFILE_CORES][NEON_PROFILE_FUNCTIONS] = {{")
+        for core in range(len(cost_cores)):
+            print(f"\t{{ // {cost_cores[core]}")
+            for i in range(0, len(costs), 16):
+                print("\t\t" + " ".join(f"{c[1][core][field]:g}," for c in costs[i:i + 16]))
+            print("\t},")
+        print("};")
+    print("} } // namespace neon::profile")
+    print("#endif")
+    print("#include \"neon_profile.h\"")
+    print("#include \"neon_trace.h\"")
+
+def parenthesized(w):
+    # clang's lane and immediate intrinsics are macros, so after arm_neon.h a
+    # template of the same name is declared as (name)
+    return re.sub(r"^(template <int \w+> inline \S+ )(\w+)\(", r"\1(\2)(", w)
+
+# wrappers the emulation has but arm_neon.h doesn't, so never native
+no_intrinsic = {"vabd_s64", "vabd_u64", "vabdq_s64", "vabdq_u64"}
+
+def native_wrappers(w):
+    # NEON_CHECKED: the native intrinsic and the neon::emulated wrapper side
+    # by side; NEON_PROFILE or NEON_TRACE alone: the native intrinsic, to be
+    # instrumented. The lane and immediate forms pass their constant on to
+    # the intrinsic.
+    constant, rtype, name, params = re.match(signature, w).groups()
+    params = [p.rsplit(" ", 1) for p in params.split(", ")]
+    if name in no_intrinsic:
+        return None
+
+    native, emulated = [], []
+    for ptype, pname in params:
+        m = re.match(r"neon::arg<(\w+)>", ptype)
+        native.append(f"{m.group(1) if m else ptype} {pname}")
+        emulated.append(f"neon::checked::emulate<neon::emulated::{m.group(1)}>({pname})" if m else pname)
+    names = ", ".join(p[1] for p in params)
+    head = f"template <int {constant}> inline" if constant else "inline"
+    intrinsic = f"NEON_NATIVE_INTRINSIC({name})({names}, {constant})" if constant else f"(::{name})({names})"
+    emulation = f"neon::emulated::{name}<{constant}>" if constant else f"neon::emulated::{name}"
+
+    if rtype == "void":
+        store = params[0][1]
+        value = params[-1][1]
+        ptype = params[0][0][:-1]
+        emulated[0] = "p"
+        return (f"{head} void {name}({', '.join(native)}) {{ neon::checked::store(\"{name}\", {store}, sizeof({value}), "
+                f"[&] {{ {intrinsic}; }}, [&]({ptype}* p) {{ {emulation}({', '.join(emulated)}); }}); }}",
+                f"{head} void {name}({', '.join(native)}) {{ {intrinsic}; }}")
+    return (f"{head} {rtype} {name}({', '.join(native)}) {{ return neon::checked::result(\"{name}\", "
+            f"{intrinsic}, {emulation}({', '.join(emulated)})); }}",
+            f"{head} {rtype} {name}({', '.join(native)}) {{ return {intrinsic}; }}")
+
+if not dispatch:
+    # aarch64 uses arm_neon.h (neon_native.h), the emulation everywhere else
+    # or with NEON_EMULATE.
+    native = [tuple(map(parenthesized, n)) for n in map(native_wrappers, functions) if n]
+
+    print_instrumentation()
+    print("#if defined(__aarch64__) && !defined(NEON_EMULATE)")
+    print("#include \"neon_native.h\"")
+    print("#if defined(NEON_CHECKED)")
+    print("namespace neon { namespace emulated {")
+    print("\n".join(map(parenthesized, functions)))
+    print("} } // namespace neon::emulated")
+    print("namespace neon { namespace checked {")
+    print("\n".join(instrumented(n[0]) for n in native))
+    print("} } // namespace neon::checked")
+    print("#define NEON_NATIVE_WRAPPERS neon::checked")
+    print("#elif defined(NEON_PROFILE) || defined(NEON_TRACE)")
+    print("namespace neon { namespace instrumented {")
+    print("\n".join(instrumented(n[1]) for n in native))
+    print("} } // namespace neon::instrumented")
+    print("#define NEON_NATIVE_WRAPPERS neon::instrumented")
+    print("#endif")
+    print("#if defined(NEON_NATIVE_WRAPPERS)")
+    for n in native:
+        name = re.match(signature, n[0]).group(3)
+        print(f"#undef {name}")
+        if name in immediates:
+            print(immediate_macro(name, "NEON_NATIVE_WRAPPERS::"))
+        else:
+            print(f"#define {name}(...) NEON_NATIVE_WRAPPERS::{name}(__VA_ARGS__)")
+    print("#endif")
+    print("#else")
+    print("#include \"neon.h\"")
+    for l in lines:
+        if l.startswith("inline "):
+            print(instrumented(l))
+        else:
+            name = re.match(r"#define (\w+)\(", l).group(1)
+            print(instrumented(templates[name]))
+            print(immediate_macro(name, "::"))
+    print("#endif")
+    sys.exit()
+
+# --dispatch: one copy of every wrapper per backend namespace, calling the
+# neon:: op unqualified so the backend's x86 overloads (or, through ADL, the
+# scalar templates) are picked, then front wrappers that switch on the
+# backend resolved at runtime. The lane and immediate forms get the same as
+# templates on the constant, which their macros call.
+print("#define NEON_RUNTIME_DISPATCH 1")
+print("#include \"neon.h\"")
+print("#include \"neon_dispatch.h\"")
+print_instrumentation()
+
+for ns, level in [("scalar", None), ("sse42", "SSE42"), ("avx2", "AVX2"), ("avx512", "AVX512")]:
+    print()
+    if level:
+        print(f"NEON_DISPATCH_BEGIN_{level}")
+        print(f"#define NEON_X86_NAMESPACE {ns}")
+        print(f"#define NEON_X86_LEVEL NEON_BACKEND_{level}")
+        print("#include \"neon_x86.h\"")
+        print("#undef NEON_X86_NAMESPACE")
+    print(f"namespace neon {{ namespace {ns} {{")
+    for w in wrappers:
+        print(re.sub(r"neon::(v\w+[<(])", r"\1", w))
+    for name in immediates:
+        print(immediate_wrapper(name, lambda constant, call, names: f"return {call};"))
+    print(f"}} }} // namespace neon::{ns}")
+    if level:
+        print("NEON_DISPATCH_END")
+
+print()
+for w in wrappers:
+    m = re.match(r"inline (\S+) (\w+)\((.*?)\) \{", w)
+    rtype, name, params = m.groups()
+    names = [p.split()[-1] for p in params.split(", ")]
+    print(instrumented(f"inline {rtype} {name}({params}) {{ return NEON_DISPATCH({name}, {', '.join(names)}); }}"))
+for name in immediates:
+    print(instrumented(immediate_wrapper(name, lambda constant, call, names: f"return NEON_DISPATCH({name}<{constant}>, {names});")))
+
+# X-macro over every generated function, for tools that walk the whole api
+# on each backend (bench.cpp)
+print()
+print("#define NEON_API_FUNCTIONS(X) \\")
+print(" \\\n".join(f"\tX({name})" for name in function_names[:len(wrappers)]))
+
+# and over the lane and immediate forms at their lowest, middle and highest
+# constant
+print()
+print("#define NEON_API_IMMEDIATE_FUNCTIONS(X) \\")
+print(" \\\n".join(f"\tX({name}<{n}>)" for name, (_, _, _, _, (lo, hi)) in immediates.items() for n in sorted({lo, (lo + hi) // 2, hi})))
+
+# and over them with their whole range, in function id order after
+# NEON_API_FUNCTIONS (replay.cpp)
+print()
+print("#define NEON_API_IMMEDIATE_RANGES(X) \\")
+print(" \\\n".join(f"\tX({name}, {lo}, {hi})" for name, (_, _, _, _, (lo, hi)) in immediates.items()))
+print()
+for name in immediates:
+    print(immediate_macro(name, "::"))
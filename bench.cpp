@@ -0,0 +1,510 @@
+// Microbenchmarks for every function in the generated api, on every backend
+// the host can run. Lane and immediate forms (vmul_lane, vshl_n, vext, ...)
+// are timed at their lowest, middle and highest lane or immediate.
+//
+//   python3 api.py --dispatch > neon_api.h
+//   g++ -std=c++14 -O2 -I. bench.cpp -o bench
+//   ./bench [--filter vadd] [--time ms] [--json bench.json] [--output bench_output.txt]
+//           [--baseline old.json] [--threshold 0.10]
+//
+// Throughput (ops/s) comes from independent calls over a ring of inputs,
+// latency (ns/op) from a chain feeding each result back into the first
+// argument of the same type; ops without one (stores, loads, reductions)
+// have no latency. The function is a template argument of the timing loops,
+// so it is inlined into them as into user code, and the loops run a batch
+// of calls between the compiler barriers that keep them from being hoisted.
+// Each backend's kernel is timed, then the api's own ::name, which adds the
+// switch on the runtime backend. Results go to a JSON file and a text
+// summary; with --baseline, any ops/s drop or latency rise above the
+// threshold against an earlier JSON file is listed and the exit code is 1.
+
+#include "neon_api.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <xmmintrin.h>
+
+namespace bench {
+
+	template <typename T>
+	inline void keep(T const& v)
+	{
+		asm volatile("" : : "r,m"(v) : "memory");
+	}
+
+	template <typename T>
+	inline void escape(T* p)
+	{
+		asm volatile("" : : "g"(p) : "memory");
+	}
+
+	// Integer lanes are kept small so shift counts and table indexes stay in
+	// range, floats in [1, 2). Scalars are 0.
+	template <typename T>
+	typename std::enable_if<neon::is_integer<T>::value>::type
+		fill_lane(T& v, std::mt19937& rng)
+	{
+		v = T(rng() & 15);
+	}
+
+	template <typename T>
+	typename std::enable_if<neon::is_ieee754<T>::value>::type
+		fill_lane(T& v, std::mt19937& rng)
+	{
+		v = T(1.0f + float(rng() & 0xffff) / 65536.0f);
+	}
+
+	template <typename T>
+	typename std::enable_if<std::is_arithmetic<T>::value || neon::is_ieee754<T>::value>::type
+		fill(T& v, std::mt19937&)
+	{
+		v = T(0);
+	}
+
+	template <typename T>
+	void fill(neon::neon64<T>& v, std::mt19937& rng)
+	{
+		for (size_t i = 0; i < v.N; i++)
+		{
+			T lane;
+			fill_lane(lane, rng);
+			v.v_[i] = lane;
+		}
+	}
+
+	template <typename T>
+	void fill(neon::neon128<T>& v, std::mt19937& rng)
+	{
+		for (size_t i = 0; i < v.N; i++)
+		{
+			T lane;
+			fill_lane(lane, rng);
+			v.v_[i] = lane;
+		}
+	}
+
+	template <typename V, size_t Count>
+	void fill(neon::neon_tuple<V, Count>& v, std::mt19937& rng)
+	{
+		for (auto& r : v.val)
+			fill(r, rng);
+	}
+
+	// Loads and stores all share one buffer per lane type, big enough for a
+	// four-register q structure.
+	template <typename T>
+	void fill(T*& p, std::mt19937& rng)
+	{
+		using lane_type = typename std::remove_const<T>::type;
+		alignas(64) static lane_type buffer[64 / sizeof(lane_type)];
+		for (auto& lane : buffer)
+			fill_lane(lane, rng);
+		p = buffer;
+	}
+
+	// First argument the result can be fed back into, or -1.
+	template <typename R, typename... A>
+	constexpr int chain_index()
+	{
+		const bool same[] = { std::is_same<R, typename std::decay<A>::type>::value..., false };
+		for (int i = 0; i < int(sizeof...(A)); i++)
+			if (same[i])
+				return i;
+		return -1;
+	}
+
+	template <typename... T, size_t... I>
+	void fill_all(std::tuple<T...>& t, std::mt19937& rng, std::index_sequence<I...>)
+	{
+		int unused[] = { (fill(std::get<I>(t), rng), 0)..., 0 };
+		(void)unused;
+	}
+
+	using clock = std::chrono::steady_clock;
+
+	// Best of five runs of body(n), in ns per op, with n grown until one run
+	// takes a quarter of the time budget.
+	template <typename Body>
+	double time_per_op(Body body, double seconds)
+	{
+		size_t n = 16;
+		for (;;)
+		{
+			auto t0 = clock::now();
+			body(n);
+			double s = std::chrono::duration<double>(clock::now() - t0).count();
+			if (s >= seconds / 4 || n >= (size_t(1) << 30))
+				break;
+			n *= 2;
+		}
+
+		double best = 0;
+		for (int run = 0; run < 5; run++)
+		{
+			auto t0 = clock::now();
+			body(n);
+			double s = std::chrono::duration<double>(clock::now() - t0).count();
+			best = run == 0 ? s : std::min(best, s);
+		}
+		return best * 1e9 / double(n);
+	}
+
+	struct result
+	{
+		std::string name;
+		int backend;
+		double ops_per_s;
+		double latency_ns; // < 0 when there's no chain
+	};
+
+	template <typename F>
+	struct measure;
+
+	template <typename R, typename... A>
+	struct measure<R (*)(A...)>
+	{
+		static constexpr size_t Batch = 8;
+		using inputs = std::tuple<typename std::decay<A>::type...>;
+		using timing = double (*)(inputs* ring, double seconds);
+
+		struct kernel
+		{
+			timing throughput;
+			timing latency;
+		};
+
+		template <R (*F)(A...), size_t... I>
+		static R call(inputs& t, std::index_sequence<I...>)
+		{
+			return F(std::get<I>(t)...);
+		}
+
+		// Stores all write the same buffer, so each one is kept separately.
+		template <R (*F)(A...)>
+		static void sink(inputs& t, std::true_type)
+		{
+			call<F>(t, std::index_sequence_for<A...>());
+			asm volatile("" : : : "memory");
+		}
+
+		template <R (*F)(A...)>
+		static void sink(inputs& t, std::false_type)
+		{
+			keep(call<F>(t, std::index_sequence_for<A...>()));
+		}
+
+		// A batch over the ring per pass, reloaded after the barrier so the
+		// calls can't be hoisted out of the loop.
+		template <R (*F)(A...)>
+		static double throughput(inputs* ring, double seconds)
+		{
+			return time_per_op([&](size_t n) {
+				for (size_t i = 0; i < n; i += Batch)
+				{
+					escape(ring);
+					for (size_t r = 0; r < Batch; r++)
+						sink<F>(ring[r], std::is_void<R>());
+				}
+			}, seconds);
+		}
+
+		template <R (*F)(A...), int I>
+		static double latency(inputs* ring, double seconds, std::integral_constant<int, I>)
+		{
+			inputs& t = ring[0];
+			return time_per_op([&](size_t n) {
+				for (size_t i = 0; i < n; i += Batch)
+					for (size_t r = 0; r < Batch; r++)
+						std::get<I>(t) = call<F>(t, std::index_sequence_for<A...>());
+				keep(std::get<I>(t));
+			}, seconds);
+		}
+
+		template <R (*F)(A...)>
+		static double latency(inputs*, double, std::integral_constant<int, -1>)
+		{
+			return -1;
+		}
+
+		template <R (*F)(A...)>
+		static double latency(inputs* ring, double seconds)
+		{
+			return latency<F>(ring, seconds, std::integral_constant<int, chain_index<R, A...>()>());
+		}
+
+		template <R (*F)(A...)>
+		static kernel of()
+		{
+			return { &throughput<F>, &latency<F> };
+		}
+
+		// Kept out of line: api functions with the same signature share it,
+		// and only the timing loops are instantiated per function.
+		__attribute__((noinline)) static result run(const char* name, int backend, kernel k, double seconds)
+		{
+			std::mt19937 rng(1);
+			inputs ring[Batch];
+			for (auto& t : ring)
+				fill_all(t, rng, std::index_sequence_for<A...>());
+			escape(ring);
+
+			double throughput_ns = k.throughput(ring, seconds);
+			double latency_ns = k.latency(ring, seconds);
+			return { name, backend, 1e9 / throughput_ns, latency_ns };
+		}
+	};
+
+	// Results of the api's ::name, next to the backends'.
+	const int api = -1;
+
+	inline const char* backend_name(int backend)
+	{
+		return backend == api ? "api" : neon::dispatch::backend_name(backend);
+	}
+
+	inline int parse_backend(const char* name)
+	{
+		return std::strcmp(name, "api") == 0 ? api : neon::dispatch::parse_backend(name);
+	}
+
+	// The backends' kernels, then the api's.
+	template <typename Measure>
+	__attribute__((noinline)) void run(std::vector<result>& results, const char* name, int top, double seconds,
+		std::array<typename Measure::kernel, 5> const& kernels)
+	{
+		for (int b = NEON_BACKEND_SCALAR; b <= top; b++)
+			results.push_back(Measure::run(name, b, kernels[b], seconds));
+		results.push_back(Measure::run(name, api, kernels[4], seconds));
+	}
+
+	struct entry
+	{
+		const char* name;
+		void (*run)(std::vector<result>& results, int top, double seconds);
+	};
+
+	struct options
+	{
+		std::string filter;
+		double seconds = 0.002;
+		std::string json = "bench.json";
+		std::string output = "bench_output.txt";
+		std::string baseline;
+		double threshold = 0.10;
+	};
+
+	inline void write_json(std::vector<result> const& results, options const& o)
+	{
+		FILE* f = std::fopen(o.json.c_str(), "w");
+		if (!f)
+		{
+			std::fprintf(stderr, "can't write %s\n", o.json.c_str());
+			return;
+		}
+		std::fprintf(f, "{\n  \"backend\": \"%s\",\n  \"time_ms\": %g,\n  \"results\": [\n",
+			neon::dispatch::backend_name(neon::dispatch::backend()), o.seconds * 1e3);
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			auto& r = results[i];
+			std::fprintf(f, "    {\"name\": \"%s\", \"backend\": \"%s\", \"ops_per_s\": %.6e, \"latency_ns\": ", r.name.c_str(), backend_name(r.backend), r.ops_per_s);
+			if (r.latency_ns < 0)
+				std::fprintf(f, "null");
+			else
+				std::fprintf(f, "%.4f", r.latency_ns);
+			std::fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+		}
+		std::fprintf(f, "  ]\n}\n");
+		std::fclose(f);
+	}
+
+	// Reads back the one-result-per-line layout write_json produces.
+	inline std::map<std::string, result> read_json(std::string const& path)
+	{
+		std::map<std::string, result> results;
+		FILE* f = std::fopen(path.c_str(), "r");
+		if (!f)
+			return results;
+
+		char line[512];
+		while (std::fgets(line, sizeof(line), f))
+		{
+			char name[128], backend[16], latency[32];
+			double ops;
+			if (std::sscanf(line, " {\"name\": \"%127[^\"]\", \"backend\": \"%15[^\"]\", \"ops_per_s\": %lf, \"latency_ns\": %31[^}]", name, backend, &ops, latency) != 4)
+				continue;
+			double latency_ns = std::strcmp(latency, "null") == 0 ? -1 : std::strtod(latency, nullptr);
+			results[std::string(name) + "/" + backend] = { name, parse_backend(backend), ops, latency_ns };
+		}
+		std::fclose(f);
+		return results;
+	}
+
+	inline std::string summary(std::vector<result> const& results, std::map<std::string, result> const& baseline, options const& o, int& regressions)
+	{
+		std::string s;
+		char line[256];
+		const int top = neon::dispatch::backend();
+
+		std::snprintf(line, sizeof(line), "neon bench: host %s, %g ms per measurement\n", neon::dispatch::backend_name(top), o.seconds * 1e3);
+		s += line;
+		s += "per backend and through the api: throughput in Mops/s, latency in ns/op (- where no argument takes the result)\n\n";
+
+		std::snprintf(line, sizeof(line), "%-24s", "function");
+		s += line;
+		for (int b = NEON_BACKEND_SCALAR; b <= top; b++)
+		{
+			std::snprintf(line, sizeof(line), " %18s", neon::dispatch::backend_name(b));
+			s += line;
+		}
+		std::snprintf(line, sizeof(line), " %18s\n", backend_name(api));
+		s += line;
+
+		// best ns/op, name, speedup of the best backend over scalar
+		std::vector<std::tuple<double, std::string, double>> slowest;
+		for (size_t i = 0; i < results.size(); )
+		{
+			size_t end = i;
+			double best = 0;
+			for (; end < results.size() && results[end].name == results[i].name; end++)
+				if (results[end].backend != api)
+					best = std::max(best, results[end].ops_per_s);
+
+			std::snprintf(line, sizeof(line), "%-24s", results[i].name.c_str());
+			s += line;
+			for (size_t j = i; j < end; j++)
+			{
+				auto& r = results[j];
+				if (r.latency_ns < 0)
+					std::snprintf(line, sizeof(line), " %10.1f %7s", r.ops_per_s * 1e-6, "-");
+				else
+					std::snprintf(line, sizeof(line), " %10.1f %7.2f", r.ops_per_s * 1e-6, r.latency_ns);
+				s += line;
+			}
+			s += "\n";
+
+			if (results[i].backend == NEON_BACKEND_SCALAR)
+				slowest.emplace_back(1e9 / best, results[i].name, best / results[i].ops_per_s);
+			i = end;
+		}
+
+		// Ranked by time rather than by speedup over scalar: an op well ahead
+		// of scalar can still be among the slowest.
+		if (!slowest.empty())
+		{
+			std::sort(slowest.rbegin(), slowest.rend());
+			s += "\nslowest on the best backend (hand-optimizing candidates)\n";
+			for (size_t i = 0; i < slowest.size() && i < 30; i++)
+			{
+				std::snprintf(line, sizeof(line), "%-24s %8.2f ns/op %8.2fx over scalar\n", std::get<1>(slowest[i]).c_str(), std::get<0>(slowest[i]), std::get<2>(slowest[i]));
+				s += line;
+			}
+		}
+
+		regressions = 0;
+		if (!o.baseline.empty())
+		{
+			if (baseline.empty())
+			{
+				std::snprintf(line, sizeof(line), "\nno results in baseline %s\n", o.baseline.c_str());
+				s += line;
+				return s;
+			}
+
+			std::snprintf(line, sizeof(line), "\nregressions against %s (threshold %g%%)\n", o.baseline.c_str(), o.threshold * 100);
+			s += line;
+			for (auto& r : results)
+			{
+				auto it = baseline.find(r.name + "/" + backend_name(r.backend));
+				if (it == baseline.end())
+					continue;
+				auto& b = it->second;
+				const char* backend = backend_name(r.backend);
+				if (r.ops_per_s < b.ops_per_s * (1 - o.threshold))
+				{
+					std::snprintf(line, sizeof(line), "%-24s %-7s throughput %.1f -> %.1f Mops/s (%+.1f%%)\n", r.name.c_str(), backend, b.ops_per_s * 1e-6, r.ops_per_s * 1e-6, (r.ops_per_s / b.ops_per_s - 1) * 100);
+					s += line;
+					regressions++;
+				}
+				if (r.latency_ns >= 0 && b.latency_ns > 0 && r.latency_ns > b.latency_ns * (1 + o.threshold))
+				{
+					std::snprintf(line, sizeof(line), "%-24s %-7s latency %.2f -> %.2f ns (%+.1f%%)\n", r.name.c_str(), backend, b.latency_ns, r.latency_ns, (r.latency_ns / b.latency_ns - 1) * 100);
+					s += line;
+					regressions++;
+				}
+			}
+			if (regressions == 0)
+				s += "none\n";
+		}
+		return s;
+	}
+
+} // namespace bench
+
+#define NEON_BENCH_FUNCTION(name) \
+	{ #name, [](std::vector<bench::result>& results, int top, double seconds) { \
+		using measure = bench::measure<decltype(&::name)>; \
+		bench::run<measure>(results, #name, top, seconds, { { measure::of<&neon::scalar::name>(), measure::of<&neon::sse42::name>(), \
+			measure::of<&neon::avx2::name>(), measure::of<&neon::avx512::name>(), measure::of<&::name>() } }); \
+	} },
+
+static const bench::entry entries[] = { NEON_API_FUNCTIONS(NEON_BENCH_FUNCTION) NEON_API_IMMEDIATE_FUNCTIONS(NEON_BENCH_FUNCTION) };
+
+int main(int argc, char** argv)
+{
+	bench::options o;
+	// every option takes a value
+	for (int i = 1; i < argc; i += 2)
+	{
+		std::string flag = argv[i];
+		if (i + 1 == argc)
+		{
+			std::fprintf(stderr, "option %s has no value\n", argv[i]);
+			return 2;
+		}
+		if (flag == "--filter") o.filter = argv[i + 1];
+		else if (flag == "--time") o.seconds = std::atof(argv[i + 1]) * 1e-3;
+		else if (flag == "--json") o.json = argv[i + 1];
+		else if (flag == "--output") o.output = argv[i + 1];
+		else if (flag == "--baseline") o.baseline = argv[i + 1];
+		else if (flag == "--threshold") o.threshold = std::atof(argv[i + 1]);
+		else
+		{
+			std::fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	// Flush denormals: float chains that decay toward zero would otherwise
+	// time the microcode assist rather than the op.
+	_mm_setcsr(_mm_getcsr() | 0x8040);
+
+	const int top = neon::dispatch::backend();
+
+	std::vector<bench::result> results;
+	for (auto& e : entries)
+		if (o.filter.empty() || std::strstr(e.name, o.filter.c_str()))
+			e.run(results, top, o.seconds);
+
+	// Read before writing, the baseline may be the previous bench.json.
+	auto baseline = bench::read_json(o.baseline);
+	bench::write_json(results, o);
+
+	int regressions = 0;
+	std::string text = bench::summary(results, baseline, o, regressions);
+	std::fputs(text.c_str(), stdout);
+	if (FILE* f = std::fopen(o.output.c_str(), "w"))
+	{
+		std::fputs(text.c_str(), f);
+		std::fclose(f);
+	}
+	return regressions ? 1 : 0;
+}
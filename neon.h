@@ -1,14 +1,32 @@
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 
 #include <array>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "float16.h"
+#include "neon_fpcr.h"
 
 using float32_t = float;
 using float64_t = double;
+#if defined(__aarch64__)
+// The same type as arm_neon.h's, so the emulation can sit next to the native
+// api (NEON_CHECKED in neon_native.h).
+using float16_t = __fp16;
+#else
 using float16_t = _Float16; 
+#endif
+
+#ifndef NEON_VECTOR_STORAGE
+#if defined(__GNUC__)
+#define NEON_VECTOR_STORAGE 1
+#else
+#define NEON_VECTOR_STORAGE 0
+#endif
+#endif
 
 static_assert(!std::is_same<float16_t, uint16_t>(), "float16 cannot be a uint16");
 
@@ -22,18 +40,21 @@ namespace neon {
 	struct ieee754<float16_t>
 	{
 		using itype = uint16_t;
+		static constexpr int mantissa = 10;
 	};
 
 	template <>
 	struct ieee754<float32_t>
 	{
 		using itype = uint32_t;
+		static constexpr int mantissa = 23;
 	};
 
 	template <>
 	struct ieee754<float64_t>
 	{
 		using itype = uint64_t;
+		static constexpr int mantissa = 52;
 	};
 
 	template <typename T>
@@ -132,738 +153,2865 @@ namespace neon {
 	template<> struct neon_type<float16_t>
 	{
 		using mask_type = uint16_t;
+		using wide_type = float32_t;
 	};
 
 	template<> struct neon_type<float32_t>
 	{
 		using mask_type = uint32_t;
+		using wide_type = float64_t;
+		using narrow_type = float16_t;
 	};
 
 	template<> struct neon_type<float64_t>
 	{
 		using mask_type = uint64_t;
+		using narrow_type = float32_t;
 	};
 
 
 
+	// Lane storage. With NEON_VECTOR_STORAGE the registers are GCC/Clang
+	// vector types, which the compiler keeps in XMM registers and passes in
+	// them by value; otherwise they are plain arrays.
+#if NEON_VECTOR_STORAGE
+	template <typename T, size_t Bytes>
+	struct storage
+	{
+		typedef T type __attribute__((vector_size(Bytes)));
+	};
+#else
+	template <typename T, size_t Bytes>
+	struct storage
+	{
+		using type = std::array<T, Bytes / sizeof(T)>;
+	};
+#endif
+
 	template <typename T>
-	struct neon128
+	struct alignas(16) neon128
 	{
 		using type = T;
 		static constexpr size_t N = 16 / sizeof(T);
-		T const& operator[](int n) const { return v_[n]; }
-		std::array<T, N> v_;
+		T operator[](int n) const { return v_[n]; }
+		typename storage<T, 16>::type v_;
 	};
 
 	template <typename T>
-	struct neon64
+	struct alignas(8) neon64
 	{
 		using type = T;
 		static constexpr size_t N = 8 / sizeof(T);
-		T const& operator[](int n) const { return v_[n]; }
-		std::array<T, N> v_;
+		T operator[](int n) const { return v_[n]; }
+		typename storage<T, 8>::type v_;
+	};
+
+	// Multi-register values (int8x16x3_t and friends), laid out back to back
+	// like the ARM val[] arrays.
+	template <typename V, size_t Count>
+	struct neon_tuple
+	{
+		V val[Count];
 	};
 
+	// Argument type of the generated wrappers in neon_api.h. Tuples are too big
+	// for registers and always go by reference.
+	template <typename V>
+	using arg = typename std::conditional<NEON_VECTOR_STORAGE && sizeof(V) <= 16, V, V const&>::type;
+
+
+	// Cumulative saturation flag (FPSR.QC) of the calling thread. Saturating
+	// ops set it whenever they clamp a lane; only the caller clears it.
+	inline bool& fpsr_qc()
+	{
+		static thread_local bool qc = false;
+		return qc;
+	}
 
+	// The FPCR controls MXCSR can't express (neon_fpcr.h), applied by the api
+	// wrappers as fixups: DN replaces NaN lanes with the default NaN, FZ16
+	// flushes half-precision denormals to zero. Arithmetic takes both on its
+	// result and FZ16 on its half-precision operands; conversions only take
+	// DN, as FZ16 doesn't apply to them. Each costs a test of the register
+	// when the bits are clear.
 	template <typename T>
-	typename std::enable_if <is_integer<T>::value, neon128<T>>::type
-		vabd(neon128<T> const& a0, neon128<T> const& a1)
+	typename std::enable_if<is_ieee754<T>::value, T>::type
+		fpcr_fixup(T a, uint32_t fpcr)
 	{
-		using signed_type = typename std::make_signed<T>::type;
+		using itype = typename ieee754<T>::itype;
+		constexpr int mantissa = ieee754<T>::mantissa;
+		constexpr itype sign = itype(itype(1) << (sizeof(T) * 8 - 1));
+		constexpr itype exponent = itype(itype(sign - 1) >> mantissa << mantissa);
+		itype i;
+		std::memcpy(&i, &a, sizeof(T));
+		if ((fpcr & fpcr_dn) && a != a)
+			i = itype(exponent | itype(1) << (mantissa - 1));
+		else if ((fpcr & fpcr_fz16) && sizeof(T) == 2 && !(i & exponent))
+			i &= sign;
+		std::memcpy(&a, &i, sizeof(T));
+		return a;
+	}
 
-		neon128<T> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = std::abs(signed_type(a0.v_[i]) - signed_type(a1.v_[i]));
-		return r;
+	template <typename T>
+	neon64<T> fpcr_fixup(neon64<T> a, uint32_t fpcr, size_t first = 0)
+	{
+		for (size_t i = first; i < neon64<T>::N; i++)
+			a.v_[i] = fpcr_fixup(a[i], fpcr);
+		return a;
 	}
 
 	template <typename T>
-	typename std::enable_if <is_ieee754<T>::value, neon128<T>>::type
-		vabd(neon128<T> const& a0, neon128<T> const& a1)
+	neon128<T> fpcr_fixup(neon128<T> a, uint32_t fpcr, size_t first = 0)
 	{
-		neon128<T> r;
-		for (int i = 0; i < neon128<float>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i] - a1.v_[i]);
-		return r;
+		for (size_t i = first; i < neon128<T>::N; i++)
+			a.v_[i] = fpcr_fixup(a[i], fpcr);
+		return a;
+	}
+
+	template <typename V>
+	struct fpcr_lanes
+	{
+		using type = typename V::type;
+	};
+
+	template <>
+	struct fpcr_lanes<float16_t>
+	{
+		using type = float16_t;
+	};
+
+	template <>
+	struct fpcr_lanes<float32_t>
+	{
+		using type = float32_t;
+	};
+
+	template <>
+	struct fpcr_lanes<float64_t>
+	{
+		using type = float64_t;
+	};
+
+	// The FPCR bits a fixup of V's lanes has work for, out of bits.
+	template <typename V>
+	uint32_t fpcr_bits(uint32_t bits)
+	{
+		return get_fpcr() & bits & (sizeof(typename fpcr_lanes<V>::type) == 2 ? fpcr_dn | fpcr_fz16 : fpcr_dn);
+	}
+
+	template <typename V>
+	V fpcr_result(V const& a)
+	{
+		const uint32_t fpcr = fpcr_bits<V>(fpcr_dn | fpcr_fz16);
+		return fpcr ? fpcr_fixup(a, fpcr) : a;
+	}
+
+	template <typename V>
+	V fpcr_operand(V const& a)
+	{
+		const uint32_t fpcr = fpcr_bits<V>(fpcr_fz16);
+		return fpcr ? fpcr_fixup(a, fpcr) : a;
 	}
 
+	template <typename V>
+	V fpcr_convert(V const& a)
+	{
+		const uint32_t fpcr = fpcr_bits<V>(fpcr_dn);
+		return fpcr ? fpcr_fixup(a, fpcr) : a;
+	}
 
+	// vcvt_high narrowing: the low half is the first operand, passed through.
 	template <typename T>
-	typename std::enable_if <is_integer<T>::value, neon64<T>>::type
-		vabd(neon64<T> const& a0, neon64<T> const& a1)
+	neon128<T> fpcr_convert_high(neon128<T> const& a)
 	{
-		using signed_type = typename std::make_signed<T>::type;
+		const uint32_t fpcr = fpcr_bits<neon128<T>>(fpcr_dn);
+		return fpcr ? fpcr_fixup(a, fpcr, neon128<T>::N / 2) : a;
+	}
 
-		neon64<T> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = std::abs(signed_type(a0.v_[i]) - signed_type(a1.v_[i]));
-		return r;
+	template <typename T>
+	T saturated(bool negative)
+	{
+		fpsr_qc() = true;
+		return negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
 	}
 
 	template <typename T>
-	typename std::enable_if <is_ieee754<T>::value, neon64<T>>::type
-		vabd(neon64<T> const& a0, neon64<T> const& a1)
+	typename std::enable_if<std::is_signed<T>::value, T>::type
+		sat_add(T a, T b)
 	{
-		neon64<T> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i] - a1.v_[i]);
-		return r;
+		using unsigned_type = typename std::make_unsigned<T>::type;
+		T r = T(unsigned_type(a) + unsigned_type(b));
+		return ((a ^ r) & (b ^ r)) < 0 ? saturated<T>(a < 0) : r;
 	}
 
 	template <typename T>
-	neon128<T>
-		vabs(neon128<T> const& a)
+	typename std::enable_if<std::is_unsigned<T>::value, T>::type
+		sat_add(T a, T b)
 	{
-		neon128<T> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = std::abs(a.v_[i]);
-		return r;
+		T r = T(a + b);
+		return r < a ? saturated<T>(false) : r;
 	}
 
 	template <typename T>
-	neon64<T>
-		vabs(neon64<T> const& a)
+	typename std::enable_if<std::is_signed<T>::value, T>::type
+		sat_sub(T a, T b)
 	{
-		neon64<T> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = std::abs(a.v_[i]);
-		return r;
+		using unsigned_type = typename std::make_unsigned<T>::type;
+		T r = T(unsigned_type(a) - unsigned_type(b));
+		return ((a ^ b) & (a ^ r)) < 0 ? saturated<T>(a < 0) : r;
 	}
 
 	template <typename T>
-	neon128<T>
-		vadd(neon128<T> const& a0, neon128<T> const& a1)
+	typename std::enable_if<std::is_unsigned<T>::value, T>::type
+		sat_sub(T a, T b)
 	{
-		neon128<T> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a0.v_[i] + a1.v_[i];
-		return r;
+		return a < b ? saturated<T>(true) : T(a - b);
 	}
 
 	template <typename T>
-	neon64<T>
-		vadd(neon64<T> const& a0, neon64<T> const& a1)
+	T sat_neg(T a)
 	{
-		neon64<T> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a0.v_[i] + a1.v_[i];
-		return r;
+		return a == std::numeric_limits<T>::min() ? saturated<T>(false) : T(-a);
 	}
 
 	template <typename T>
-	neon128<typename neon_type<T>::wide_type>
-		vaddl(neon64<T> const& a0, neon64<T> const& a1)
+	T sat_abs(T a)
+	{
+		return a < 0 ? sat_neg(a) : a;
+	}
+
+	// (2 * a * b [+ rounding]) >> bits, computed as (a * b [+ half]) >> (bits - 1)
+	// in the wide type so that only INT_MIN * INT_MIN can overflow.
+	template <bool Round, typename T>
+	T sat_doubling_mulh(T a, T b)
 	{
 		using wide_type = typename neon_type<T>::wide_type;
+		constexpr int bits = 8 * sizeof(T);
+		if (a == std::numeric_limits<T>::min() && b == std::numeric_limits<T>::min())
+			return saturated<T>(false);
+		wide_type p = wide_type(a) * wide_type(b) + (Round ? wide_type(1) << (bits - 2) : 0);
+		return T(p >> (bits - 1));
+	}
 
-		neon128<wide_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = wide_type(a0.v_[i]) + wide_type(a1.v_[i]);
-		return r;
+	// Modular lane arithmetic. Going through unsigned keeps signed overflow
+	// defined and stops uint16 * uint16 from promoting to a signed int.
+	template <typename T>
+	using wrap_type = typename std::common_type<typename std::make_unsigned<T>::type, unsigned>::type;
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, T>::type
+		wrap_add(T a, T b)
+	{
+		return T(wrap_type<T>(a) + wrap_type<T>(b));
 	}
 
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, T>::type
+		wrap_sub(T a, T b)
+	{
+		return T(wrap_type<T>(a) - wrap_type<T>(b));
+	}
 
 	template <typename T>
-	neon128<typename neon_type<T>::wide_type>
-		vaddl_high(neon128<T> const& a0, neon128<T> const& a1)
+	typename std::enable_if<is_integer<T>::value, T>::type
+		wrap_mul(T a, T b)
 	{
-		using wide_type = typename neon_type<T>::wide_type;
+		return T(wrap_type<T>(a) * wrap_type<T>(b));
+	}
 
-		neon128<wide_type> r;
-		for (int i = 0; i < neon128<wide_type>::N; i++)
-		{
-			auto pos = neon128<wide_type>::N + i;
-			r.v_[i] = wide_type(a0.v_[pos]) + wide_type(a1.v_[pos]);
-		}
-		return r;
+	// |a - b| always fits the unsigned type of the lanes.
+	template <typename T>
+	typename std::make_unsigned<T>::type abs_diff(T a, T b)
+	{
+		using unsigned_type = typename std::make_unsigned<T>::type;
+		return a > b ? unsigned_type(unsigned_type(a) - unsigned_type(b)) : unsigned_type(unsigned_type(b) - unsigned_type(a));
 	}
 
 	template <typename T>
-	neon128<typename neon_type<T>::wide_type>
-		vaddw(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1)
+	typename std::enable_if<is_ieee754<T>::value, T>::type
+		wrap_add(T a, T b)
 	{
-		using wide_type = typename neon_type<T>::wide_type;
+		return a + b;
+	}
 
-		neon128<wide_type> r;
-		for (int i = 0; i < neon128<wide_type>::N; i++)
-		{
-			r.v_[i] = a0.v_[i] + wide_type(a1.v_[i]);
-		}
-		return r;
+	template <typename T>
+	typename std::enable_if<is_ieee754<T>::value, T>::type
+		wrap_sub(T a, T b)
+	{
+		return a - b;
 	}
 
+	// Float products are rounded on their own, as on ARM where vmul and vmla
+	// never fuse with a neighbouring add; the volatile stops GCC contracting
+	// a * b + c into an fma.
 	template <typename T>
-	neon128<typename neon_type<T>::wide_type>
-		vaddw_high(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1)
+	typename std::enable_if<is_ieee754<T>::value, T>::type
+		wrap_mul(T a, T b)
 	{
-		using wide_type = typename neon_type<T>::wide_type;
+		volatile T p = a * b;
+		return p;
+	}
 
-		neon128<wide_type> r;
-		for (int i = 0; i < neon128<wide_type>::N; i++)
-		{
-			auto pos = neon128<wide_type>::N + i;
-			r.v_[i] = a0.v_[i] + wide_type(a1.v_[pos]);
-		}
-		return r;
+	// FMAX/FMIN: NaN if either operand is NaN, and +0 compares above -0.
+	template <typename T>
+	T fp_max(T a, T b)
+	{
+		if (a != a || b != b)
+			return a + b;
+		if (a == b)
+			return std::signbit(float(a)) ? b : a;
+		return a > b ? a : b;
 	}
 
 	template <typename T>
-	neon64<typename neon_type<T>::narrow_type>
-		vaddhn(neon128<T> const& a0, neon128<T> const& a1)
+	T fp_min(T a, T b)
 	{
-		using narrow_type = typename neon_type<T>::narrow_type;
+		if (a != a || b != b)
+			return a + b;
+		if (a == b)
+			return std::signbit(float(a)) ? a : b;
+		return a < b ? a : b;
+	}
 
-		neon64<narrow_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-		{
-			auto pos = neon128<narrow_type>::N + i;
+	// FMAXNM/FMINNM: a NaN operand is ignored unless both are NaN.
+	template <typename T>
+	T fp_maxnm(T a, T b)
+	{
+		return a != a ? b : b != b ? a : fp_max(a, b);
+	}
 
-			r.v_[i] = narrow_type(a0.v_[i] + a1.v_[i]);
-		}
-		return r;
+	template <typename T>
+	T fp_minnm(T a, T b)
+	{
+		return a != a ? b : b != b ? a : fp_min(a, b);
 	}
 
+	// std::abs has no _Float16 overload; clearing the sign bit is exact for
+	// every format and leaves NaN payloads alone.
 	template <typename T>
-	neon128<typename neon_type<T>::narrow_type>
-		vaddhn_high(neon64<typename neon_type<T>::narrow_type> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	typename std::enable_if<is_integer<T>::value, T>::type
+		lane_abs(T a)
 	{
-		using narrow_type = typename neon_type<T>::narrow_type;
-		neon128<narrow_type> r;
-		for (int i = 0; i < neon64<narrow_type>::N; i++)
-		{
-			r.v_[i] = a0.v_[i];
-		}
-		for (int i = 0; i < neon64<narrow_type>::N; i++)
-		{
-			auto pos = neon64<narrow_type>::N + i;
+		return T(std::abs(a));
+	}
 
-			r.v_[pos] = narrow_type(a1.v_[i] + a2.v_[i]);
-		}
-		return r;
+	template <typename T>
+	typename std::enable_if<is_ieee754<T>::value, T>::type
+		lane_abs(T a)
+	{
+		using itype = typename ieee754<T>::itype;
+
+		itype i;
+		std::memcpy(&i, &a, sizeof(T));
+		i &= itype(~(itype(1) << (sizeof(T) * 8 - 1)));
+		std::memcpy(&a, &i, sizeof(T));
+		return a;
 	}
 
 	template <typename T>
-	T
-		vaddv(neon128<T> const& a)
+	typename std::enable_if<is_integer<T>::value, T>::type
+		lane_max(T a, T b)
 	{
-		T r = a.v_[0];
-		for (int i = 1; i < neon128<T>::N; i++)
-		{
-			r += a.v_[i];
-		}
-		return r;
+		return std::max(a, b);
 	}
 
 	template <typename T>
-	T
-		vaddv(neon64<T> const& a)
+	typename std::enable_if<is_ieee754<T>::value, T>::type
+		lane_max(T a, T b)
 	{
-		T r = a.v_[0];
-		for (int i = 1; i < neon64<T>::N; i++)
-		{
-			r += a.v_[i];
-		}
-		return r;
+		return fp_max(a, b);
 	}
 
 	template <typename T>
-	neon128<T>
-		vbic(neon128<T> const& a0, neon128<T> const& a1)
+	typename std::enable_if<is_integer<T>::value, T>::type
+		lane_min(T a, T b)
 	{
-		neon128<T> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a0.v_[i] & ~a1.v_[i];
-		return r;
+		return std::min(a, b);
 	}
 
 	template <typename T>
-	neon64<T>
-		vbic(neon64<T> const& a0, neon64<T> const& a1)
+	typename std::enable_if<is_ieee754<T>::value, T>::type
+		lane_min(T a, T b)
 	{
-		neon64<T> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a0.v_[i] & ~a1.v_[i];
-		return r;
+		return fp_min(a, b);
 	}
 
+	// Lane shifts by any count n >= 0, as ARM defines them for counts past the
+	// lane width: left shifts give 0, right shifts 0 or the sign, and rounding
+	// right shifts add 2^(n-1) first in unbounded precision.
+	template <typename T>
+	T shift_left(T a, int n)
+	{
+		return n >= int(8 * sizeof(T)) ? T(0) : T(wrap_type<T>(a) << n);
+	}
 
 	template <typename T>
-	typename std::enable_if < is_integer<T>::value, neon128<T>>::type
-		vbsl(neon128<typename std::make_unsigned<T>::type> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	T shift_right(T a, int n)
 	{
-		using mask_type = typename std::make_unsigned<T>::type;
-		neon128<T> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = (a0.v_[i] & mask_type(a1.v_[i])) | (~a0.v_[i] & mask_type(a2.v_[i]));
-		return r;
+		return n >= int(8 * sizeof(T)) ? T(a < 0 ? -1 : 0) : T(a >> n);
 	}
 
 	template <typename T>
-	typename std::enable_if < is_integer<T>::value, neon64<T>>::type
-		vbsl(neon64<typename std::make_unsigned<T>::type> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	T rounding_shift_right(T a, int n)
 	{
-		using mask_type = typename std::make_unsigned<T>::type;
-		neon64<T> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = (a0.v_[i] & mask_type(a1.v_[i])) | (~a0.v_[i] & mask_type(a2.v_[i]));
-		return r;
+		if (n == 0)
+			return a;
+		return n > int(8 * sizeof(T)) ? T(0) : wrap_add(shift_right(a, n), T(shift_right(a, n - 1) & 1));
 	}
 
 	template <typename T>
-	typename std::enable_if <is_ieee754<T>::value, neon128<T>>::type
-		vbsl(neon128<typename ieee754<T>::itype> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	T sat_shift_left(T a, int n)
 	{
-		using itype = typename ieee754<T>::itype;
-		neon128<T> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-		{
-			static_assert(sizeof(T) == sizeof(itype), "Assumption is false");
-			const itype um = a0.v_[i];
-			const itype ua = *reinterpret_cast<const itype*>(&a1.v_[i]);
-			const itype ub = *reinterpret_cast<const itype*>(&a2.v_[i]);
-			itype ur = (um & ua) | (~um & ub);
+		T r = shift_left(a, n);
+		return a != 0 && (n >= int(8 * sizeof(T)) || shift_right(r, n) != a) ? saturated<T>(a < 0) : r;
+	}
 
-			r.v_[i] = *reinterpret_cast<T*>(&ur);
-		}
-		return r;
+	// Register shifts (vshl, vrshl, vqshl) take the signed low byte of each
+	// count lane; negative counts shift right.
+	template <typename C>
+	int shift_count(C count)
+	{
+		return int8_t(count);
 	}
 
+	// The immediates: 0 to bits - 1 for left shifts, 1 to bits for right ones.
 	template <typename T>
-	typename std::enable_if <is_ieee754<T>::value, neon64<T>>::type
-		vbsl(neon64<typename ieee754<T>::itype> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	constexpr bool left_shift(int n)
 	{
-		using itype = typename ieee754<T>::itype;
-		neon64<T> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-		{
-			static_assert(sizeof(T) == sizeof(itype), "Assumption is false");
-			const itype um = a0.v_[i];
-			const itype ua = *reinterpret_cast<const itype*>(&a1.v_[i]);
-			const itype ub = *reinterpret_cast<const itype*>(&a2.v_[i]);
-			itype ur = (um & ua) | (~um & ub);
+		return n >= 0 && n < int(8 * sizeof(T));
+	}
 
-			r.v_[i] = *reinterpret_cast<T*>(&ur);
-		}
-		return r;
+	template <typename T>
+	constexpr bool right_shift(int n)
+	{
+		return n >= 1 && n <= int(8 * sizeof(T));
+	}
+
+	// Saturating narrow to R, for vqmovn and the vqshrn family.
+	template <typename R, typename T>
+	R sat_narrow(T a)
+	{
+		if (a > T(std::numeric_limits<R>::max()))
+			return saturated<R>(false);
+		if (a < T(std::numeric_limits<R>::min()))
+			return saturated<R>(true);
+		return R(a);
+	}
+
+	// Across-lanes reduction in the order of ARM's Reduce(): adjacent pairs,
+	// then pairs of pairs, which is what fixes the rounding of float sums.
+	template <typename R, typename V>
+	R reduce(V const& a, R (*op)(R, R))
+	{
+		R t[V::N];
+		for (size_t i = 0; i < V::N; i++)
+			t[i] = R(a.v_[i]);
+		for (size_t n = V::N; n > 1; n /= 2)
+			for (size_t i = 0; i < n / 2; i++)
+				t[i] = op(t[2 * i], t[2 * i + 1]);
+		return t[0];
 	}
 
 	template <typename T>
-	neon128<T>
-		vbcax(neon128<T> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	typename std::enable_if <is_integer<T>::value, neon128<T>>::type
+		vabd(neon128<T> const& a0, neon128<T> const& a1)
 	{
-		//vn = a0
-		//vm = a1
-		//va = a2
 		neon128<T> r;
 		for (int i = 0; i < neon128<T>::N; i++)
-		{
-			r.v_[i] = a0.v_[i] ^ (a1.v_[i] & ~a2.v_[i]);
-		}
+			r.v_[i] = T(abs_diff(a0.v_[i], a1.v_[i]));
 		return r;
 	}
 
 	template <typename T>
-	neon64<T>
+	typename std::enable_if <is_ieee754<T>::value, neon128<T>>::type
+		vabd(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i] - a1.v_[i]);
+		return r;
+	}
+
+
+	template <typename T>
+	typename std::enable_if <is_integer<T>::value, neon64<T>>::type
+		vabd(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = T(abs_diff(a0.v_[i], a1.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if <is_ieee754<T>::value, neon64<T>>::type
+		vabd(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i] - a1.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, neon128<T>>::type
+		vaba(neon128<T> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], T(abs_diff(a1.v_[i], a2.v_[i])));
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, neon64<T>>::type
+		vaba(neon64<T> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], T(abs_diff(a1.v_[i], a2.v_[i])));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vabal(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], wide_type(abs_diff(a1.v_[i], a2.v_[i])));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vabal_high(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+		{
+			auto pos = neon128<wide_type>::N + i;
+			r.v_[i] = wrap_add(a0.v_[i], wide_type(abs_diff(a1.v_[pos], a2.v_[pos])));
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vabdl(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wide_type(abs_diff(a0.v_[i], a1.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vabdl_high(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+		{
+			auto pos = neon128<wide_type>::N + i;
+			r.v_[i] = wide_type(abs_diff(a0.v_[pos], a1.v_[pos]));
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vabs(neon128<T> const& a)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = lane_abs(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vabs(neon64<T> const& a)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = lane_abs(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vadd(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] + a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vadd(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] + a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vaddl(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = wide_type(a0.v_[i]) + wide_type(a1.v_[i]);
+		return r;
+	}
+
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vaddl_high(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+		{
+			auto pos = neon128<wide_type>::N + i;
+			r.v_[i] = wide_type(a0.v_[pos]) + wide_type(a1.v_[pos]);
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vaddw(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+		{
+			r.v_[i] = a0.v_[i] + wide_type(a1.v_[i]);
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vaddw_high(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+		{
+			auto pos = neon128<wide_type>::N + i;
+			r.v_[i] = a0.v_[i] + wide_type(a1.v_[pos]);
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon64<typename neon_type<T>::narrow_type>
+		vaddhn(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using narrow_type = typename neon_type<T>::narrow_type;
+
+		neon64<narrow_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = narrow_type(shift_right(wrap_add(a0.v_[i], a1.v_[i]), 8 * sizeof(narrow_type)));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::narrow_type>
+		vaddhn_high(neon64<typename neon_type<T>::narrow_type> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		using narrow_type = typename neon_type<T>::narrow_type;
+		neon128<narrow_type> r;
+		for (int i = 0; i < neon64<narrow_type>::N; i++)
+		{
+			r.v_[i] = a0.v_[i];
+		}
+		for (int i = 0; i < neon64<narrow_type>::N; i++)
+		{
+			auto pos = neon64<narrow_type>::N + i;
+
+			r.v_[pos] = narrow_type(shift_right(wrap_add(a1.v_[i], a2.v_[i]), 8 * sizeof(narrow_type)));
+		}
+		return r;
+	}
+
+	template <typename T>
+	T
+		vaddv(neon128<T> const& a)
+	{
+		return reduce<T>(a, &wrap_add<T>);
+	}
+
+	template <typename T>
+	T
+		vaddv(neon64<T> const& a)
+	{
+		return reduce<T>(a, &wrap_add<T>);
+	}
+
+	template <typename T>
+	typename neon_type<T>::wide_type
+		vaddlv(neon128<T> const& a)
+	{
+		return reduce<typename neon_type<T>::wide_type>(a, &wrap_add<typename neon_type<T>::wide_type>);
+	}
+
+	template <typename T>
+	typename neon_type<T>::wide_type
+		vaddlv(neon64<T> const& a)
+	{
+		return reduce<typename neon_type<T>::wide_type>(a, &wrap_add<typename neon_type<T>::wide_type>);
+	}
+
+	template <typename T>
+	neon128<T>
+		vand(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] & a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vand(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] & a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vbic(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] & ~a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vbic(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] & ~a1.v_[i];
+		return r;
+	}
+
+
+	template <typename T>
+	typename std::enable_if < is_integer<T>::value, neon128<T>>::type
+		vbsl(neon128<typename std::make_unsigned<T>::type> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		using mask_type = typename std::make_unsigned<T>::type;
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = (a0.v_[i] & mask_type(a1.v_[i])) | (~a0.v_[i] & mask_type(a2.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if < is_integer<T>::value, neon64<T>>::type
+		vbsl(neon64<typename std::make_unsigned<T>::type> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		using mask_type = typename std::make_unsigned<T>::type;
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = (a0.v_[i] & mask_type(a1.v_[i])) | (~a0.v_[i] & mask_type(a2.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if <is_ieee754<T>::value, neon128<T>>::type
+		vbsl(neon128<typename ieee754<T>::itype> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		using itype = typename ieee754<T>::itype;
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+		{
+			static_assert(sizeof(T) == sizeof(itype), "Assumption is false");
+			const itype um = a0.v_[i];
+			itype ua, ub;
+			std::memcpy(&ua, &a1.v_[i], sizeof(T));
+			std::memcpy(&ub, &a2.v_[i], sizeof(T));
+			itype ur = (um & ua) | (~um & ub);
+
+			std::memcpy(&r.v_[i], &ur, sizeof(T));
+		}
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if <is_ieee754<T>::value, neon64<T>>::type
+		vbsl(neon64<typename ieee754<T>::itype> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		using itype = typename ieee754<T>::itype;
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+		{
+			static_assert(sizeof(T) == sizeof(itype), "Assumption is false");
+			const itype um = a0.v_[i];
+			itype ua, ub;
+			std::memcpy(&ua, &a1.v_[i], sizeof(T));
+			std::memcpy(&ub, &a2.v_[i], sizeof(T));
+			itype ur = (um & ua) | (~um & ub);
+
+			std::memcpy(&r.v_[i], &ur, sizeof(T));
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vbcax(neon128<T> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		//vn = a0
+		//vm = a1
+		//va = a2
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+		{
+			r.v_[i] = a0.v_[i] ^ (a1.v_[i] & ~a2.v_[i]);
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
 		vbcax(neon64<T> const& a0, neon64<T> const& a1, neon64<T> const& a2)
 	{
-		//vn = a0
-		//vm = a1
-		//va = a2
+		//vn = a0
+		//vm = a1
+		//va = a2
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+		{
+			r.v_[i] = a0.v_[i] ^ (a1.v_[i] & ~a2.v_[i]);
+		}
+		return r;
+	}
+
+	
+	template <typename T, typename = void>
+	struct cmptype {};
+
+	template <typename T> 
+	struct cmptype<T, typename std::enable_if<std::is_integral<T>::value>::type>
+	{ using type = typename std::make_unsigned<T>::type; };
+	
+	template <typename T> 
+	struct cmptype<T, typename std::enable_if<is_ieee754<T>::value>::type> 
+	{ using type = typename ieee754<T>::itype; };
+
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vceq(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+	
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] == a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+	
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vceq(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] == a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vceqz(neon128<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a.v_[i] == T(0) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vceqz(neon64<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a.v_[i] == T(0) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcge(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] >= a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcge(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] >= a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcgez(neon128<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a.v_[i] >= T(0) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcgez(neon64<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a.v_[i] >= 0 ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcle(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] <= a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcle(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] <= a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vclez(neon128<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a.v_[i] <= T(0) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vclez(neon64<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a.v_[i] <= 0 ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcgt(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] > a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcgt(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] > a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcgtz(neon128<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a.v_[i] > T(0) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcgtz(neon64<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a.v_[i] > 0 ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vclt(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] < a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vclt(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] < a1.v_[i] ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcltz(neon128<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a.v_[i] < T(0) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcltz(neon64<T> const& a)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a.v_[i] < 0 ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcage(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i]) >= lane_abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcage(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i]) >= lane_abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcale(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i]) <= lane_abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcale(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i]) <= lane_abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcagt(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i]) > lane_abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcagt(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i]) > lane_abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename cmptype<T>::type>
+		vcalt(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon128<mask_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i]) < lane_abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+
+	template <typename T>
+	neon64<typename cmptype<T>::type>
+		vcalt(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using mask_type = typename cmptype<T>::type;
+
+		neon64<mask_type> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = lane_abs(a0.v_[i]) < lane_abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		return r;
+	}
+
+	// FCVTZS/FCVTZU truncate and saturate, and convert NaN to 0; a C++ cast
+	// leaves those lanes to the host (or to the optimizer).
+	template <typename OUTT, typename T>
+	OUTT cvt_lane(T a)
+	{
+		const double x = double(a);
+		if (x != x)
+			return 0;
+		if (x <= double(std::numeric_limits<OUTT>::min()))
+			return std::numeric_limits<OUTT>::min();
+		if (x >= double(std::numeric_limits<OUTT>::max()))
+			return std::numeric_limits<OUTT>::max();
+		return OUTT(x);
+	}
+
+	template <typename OUTT, typename T>
+	neon64<OUTT>
+		vcvt(neon64<T> const& a)
+	{
+		neon64<OUTT> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = cvt_lane<OUTT>(a.v_[i]);
+		return r;
+	}
+
+	template <typename OUTT, typename T>
+	neon128<OUTT>
+		vcvt(neon128<T> const& a)
+	{
+		neon128<OUTT> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = cvt_lane<OUTT>(a.v_[i]);
+		return r;
+	}
+
+	// Float width changes: FCVTL widens the low half (or the high half for
+	// _high), FCVTN narrows into a d register or into the high half of a0.
+	template <typename T>
+	typename std::enable_if<is_ieee754<T>::value, neon128<typename neon_type<T>::wide_type>>::type
+		vcvt_long(neon64<T> const& a)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wide_type(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_ieee754<T>::value, neon128<typename neon_type<T>::wide_type>>::type
+		vcvt_long_high(neon128<T> const& a)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wide_type(a.v_[neon128<wide_type>::N + i]);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_ieee754<T>::value, neon64<typename neon_type<T>::narrow_type>>::type
+		vcvt_narrow(neon128<T> const& a)
+	{
+		using narrow_type = typename neon_type<T>::narrow_type;
+
+		neon64<narrow_type> r;
+		for (int i = 0; i < neon64<narrow_type>::N; i++)
+			r.v_[i] = narrow_type(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_ieee754<T>::value, neon128<typename neon_type<T>::narrow_type>>::type
+		vcvt_narrow_high(neon64<typename neon_type<T>::narrow_type> const& a0, neon128<T> const& a1)
+	{
+		using narrow_type = typename neon_type<T>::narrow_type;
+
+		neon128<narrow_type> r;
+		for (int i = 0; i < neon64<narrow_type>::N; i++)
+		{
+			r.v_[i] = a0.v_[i];
+			r.v_[neon64<narrow_type>::N + i] = narrow_type(a1.v_[i]);
+		}
+		return r;
+	}
+
+	template <typename R>
+	R
+		vdup_n(typename R::type a)
+	{
+		R r;
+		for (int i = 0; i < R::N; i++)
+			r.v_[i] = a;
+		return r;
+	}
+
+	template <int Lane, typename R, typename V>
+	R
+		vdup_lane(V const& a)
+	{
+		static_assert(Lane >= 0 && Lane < V::N, "lane out of range");
+		static_assert(std::is_same<typename R::type, typename V::type>::value, "lane type mismatch");
+
+		R r;
+		for (int i = 0; i < R::N; i++)
+			r.v_[i] = a.v_[Lane];
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		veor(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] ^ a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		veor(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] ^ a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		veor3(neon128<T> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] ^ a1.v_[i] ^ a2.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		veor3(neon64<T> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] ^ a1.v_[i] ^ a2.v_[i];
+		return r;
+	}
+
+	// Fused: a0 + a1 * a2 with a single rounding, unlike vmla.
+	template <typename T>
+	neon128<T>
+		vfma(neon128<T> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = std::fma(a1.v_[i], a2.v_[i], a0.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vfma(neon64<T> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = std::fma(a1.v_[i], a2.v_[i], a0.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vfms(neon128<T> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = std::fma(-a1.v_[i], a2.v_[i], a0.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vfms(neon64<T> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = std::fma(-a1.v_[i], a2.v_[i], a0.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vfma_n(neon128<T> const& a0, neon128<T> const& a1, T a2)
+	{
+		return vfma(a0, a1, vdup_n<neon128<T>>(a2));
+	}
+
+	template <typename T>
+	neon64<T>
+		vfma_n(neon64<T> const& a0, neon64<T> const& a1, T a2)
+	{
+		return vfma(a0, a1, vdup_n<neon64<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<T>
+		vfma_lane(neon128<T> const& a0, neon128<T> const& a1, V const& a2)
+	{
+		return vfma(a0, a1, vdup_lane<Lane, neon128<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon64<T>
+		vfma_lane(neon64<T> const& a0, neon64<T> const& a1, V const& a2)
+	{
+		return vfma(a0, a1, vdup_lane<Lane, neon64<T>>(a2));
+	}
+
+	template <typename T>
+	neon128<T>
+		vfms_n(neon128<T> const& a0, neon128<T> const& a1, T a2)
+	{
+		return vfms(a0, a1, vdup_n<neon128<T>>(a2));
+	}
+
+	template <typename T>
+	neon64<T>
+		vfms_n(neon64<T> const& a0, neon64<T> const& a1, T a2)
+	{
+		return vfms(a0, a1, vdup_n<neon64<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<T>
+		vfms_lane(neon128<T> const& a0, neon128<T> const& a1, V const& a2)
+	{
+		return vfms(a0, a1, vdup_lane<Lane, neon128<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon64<T>
+		vfms_lane(neon64<T> const& a0, neon64<T> const& a1, V const& a2)
+	{
+		return vfms(a0, a1, vdup_lane<Lane, neon64<T>>(a2));
+	}
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, neon128<T>>::type
+		vhadd(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = T((wide_type(a0.v_[i]) + wide_type(a1.v_[i])) >> 1);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, neon64<T>>::type
+		vhadd(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = T((wide_type(a0.v_[i]) + wide_type(a1.v_[i])) >> 1);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, neon128<T>>::type
+		vrhadd(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = T((wide_type(a0.v_[i]) + wide_type(a1.v_[i]) + 1) >> 1);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, neon64<T>>::type
+		vrhadd(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = T((wide_type(a0.v_[i]) + wide_type(a1.v_[i]) + 1) >> 1);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, neon128<T>>::type
+		vhsub(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = T((wide_type(a0.v_[i]) - wide_type(a1.v_[i])) >> 1);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<is_integer<T>::value, neon64<T>>::type
+		vhsub(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = T((wide_type(a0.v_[i]) - wide_type(a1.v_[i])) >> 1);
+		return r;
+	}
+
+	template <typename V>
+	V
+		vld1(typename V::type const* p)
+	{
+		V r;
+		std::memcpy(&r.v_, p, sizeof(r.v_));
+		return r;
+	}
+
+	template <typename V, size_t Count>
+	neon_tuple<V, Count>
+		vld1_x(typename V::type const* p)
+	{
+		neon_tuple<V, Count> r;
+		for (size_t i = 0; i < Count; i++)
+			std::memcpy(&r.val[i].v_, p + i * V::N, sizeof(r.val[i].v_));
+		return r;
+	}
+
+	template <typename V>
+	V
+		vld1_dup(typename V::type const* p)
+	{
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = *p;
+		return r;
+	}
+
+	template <int Lane, typename V>
+	V
+		vld1_lane(typename V::type const* p, V const& a)
+	{
+		static_assert(Lane >= 0 && Lane < V::N, "lane out of range");
+
+		V r = a;
+		r.v_[Lane] = *p;
+		return r;
+	}
+
+	template <typename V, size_t Count>
+	neon_tuple<V, Count>
+		vldn(typename V::type const* p)
+	{
+		neon_tuple<V, Count> r;
+		for (int i = 0; i < V::N; i++)
+			for (size_t j = 0; j < Count; j++)
+				r.val[j].v_[i] = p[i * Count + j];
+		return r;
+	}
+
+	template <typename V, size_t Count>
+	neon_tuple<V, Count>
+		vldn_dup(typename V::type const* p)
+	{
+		neon_tuple<V, Count> r;
+		for (size_t j = 0; j < Count; j++)
+			for (int i = 0; i < V::N; i++)
+				r.val[j].v_[i] = p[j];
+		return r;
+	}
+
+	template <int Lane, typename V, size_t Count>
+	neon_tuple<V, Count>
+		vldn_lane(typename V::type const* p, neon_tuple<V, Count> const& a)
+	{
+		static_assert(Lane >= 0 && Lane < V::N, "lane out of range");
+
+		neon_tuple<V, Count> r = a;
+		for (size_t j = 0; j < Count; j++)
+			r.val[j].v_[Lane] = p[j];
+		return r;
+	}
+
+	template <typename T>
+	T
+		vmaxv(neon128<T> const& a)
+	{
+		return reduce<T>(a, &lane_max<T>);
+	}
+
+	template <typename T>
+	T
+		vmaxv(neon64<T> const& a)
+	{
+		return reduce<T>(a, &lane_max<T>);
+	}
+
+	template <typename T>
+	T
+		vmaxnmv(neon128<T> const& a)
+	{
+		return reduce<T>(a, &fp_maxnm<T>);
+	}
+
+	template <typename T>
+	T
+		vmaxnmv(neon64<T> const& a)
+	{
+		return reduce<T>(a, &fp_maxnm<T>);
+	}
+
+	template <typename T>
+	T
+		vminv(neon128<T> const& a)
+	{
+		return reduce<T>(a, &lane_min<T>);
+	}
+
+	template <typename T>
+	T
+		vminv(neon64<T> const& a)
+	{
+		return reduce<T>(a, &lane_min<T>);
+	}
+
+	template <typename T>
+	T
+		vminnmv(neon128<T> const& a)
+	{
+		return reduce<T>(a, &fp_minnm<T>);
+	}
+
+	template <typename T>
+	T
+		vminnmv(neon64<T> const& a)
+	{
+		return reduce<T>(a, &fp_minnm<T>);
+	}
+
+	template <typename T>
+	neon128<T>
+		vmla(neon128<T> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], wrap_mul(a1.v_[i], a2.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vmla(neon64<T> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], wrap_mul(a1.v_[i], a2.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmlal(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], wrap_mul(wide_type(a1.v_[i]), wide_type(a2.v_[i])));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmlal_high(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+		{
+			auto pos = neon128<wide_type>::N + i;
+			r.v_[i] = wrap_add(a0.v_[i], wrap_mul(wide_type(a1.v_[pos]), wide_type(a2.v_[pos])));
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vmls(neon128<T> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = wrap_sub(a0.v_[i], wrap_mul(a1.v_[i], a2.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vmls(neon64<T> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = wrap_sub(a0.v_[i], wrap_mul(a1.v_[i], a2.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmlsl(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1, neon64<T> const& a2)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wrap_sub(a0.v_[i], wrap_mul(wide_type(a1.v_[i]), wide_type(a2.v_[i])));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmlsl_high(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1, neon128<T> const& a2)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+		{
+			auto pos = neon128<wide_type>::N + i;
+			r.v_[i] = wrap_sub(a0.v_[i], wrap_mul(wide_type(a1.v_[pos]), wide_type(a2.v_[pos])));
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vmul(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = wrap_mul(a0.v_[i], a1.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vmul(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = wrap_mul(a0.v_[i], a1.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmull(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wrap_mul(wide_type(a0.v_[i]), wide_type(a1.v_[i]));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmull_high(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+		{
+			auto pos = neon128<wide_type>::N + i;
+			r.v_[i] = wrap_mul(wide_type(a0.v_[pos]), wide_type(a1.v_[pos]));
+		}
+		return r;
+	}
+
+	// The _n and _lane forms (_laneq when the lane comes from a q register)
+	// broadcast their last operand and run the plain op, so each costs one
+	// shuffle on top of it.
+	template <typename T>
+	neon128<T>
+		vmla_n(neon128<T> const& a0, neon128<T> const& a1, T a2)
+	{
+		return vmla(a0, a1, vdup_n<neon128<T>>(a2));
+	}
+
+	template <typename T>
+	neon64<T>
+		vmla_n(neon64<T> const& a0, neon64<T> const& a1, T a2)
+	{
+		return vmla(a0, a1, vdup_n<neon64<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<T>
+		vmla_lane(neon128<T> const& a0, neon128<T> const& a1, V const& a2)
+	{
+		return vmla(a0, a1, vdup_lane<Lane, neon128<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon64<T>
+		vmla_lane(neon64<T> const& a0, neon64<T> const& a1, V const& a2)
+	{
+		return vmla(a0, a1, vdup_lane<Lane, neon64<T>>(a2));
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmlal_n(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1, T a2)
+	{
+		return vmlal(a0, a1, vdup_n<neon64<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<typename neon_type<T>::wide_type>
+		vmlal_lane(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1, V const& a2)
+	{
+		return vmlal(a0, a1, vdup_lane<Lane, neon64<T>>(a2));
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmlal_high_n(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1, T a2)
+	{
+		return vmlal_high(a0, a1, vdup_n<neon128<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<typename neon_type<T>::wide_type>
+		vmlal_high_lane(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1, V const& a2)
+	{
+		return vmlal_high(a0, a1, vdup_lane<Lane, neon128<T>>(a2));
+	}
+
+	template <typename T>
+	neon128<T>
+		vmls_n(neon128<T> const& a0, neon128<T> const& a1, T a2)
+	{
+		return vmls(a0, a1, vdup_n<neon128<T>>(a2));
+	}
+
+	template <typename T>
+	neon64<T>
+		vmls_n(neon64<T> const& a0, neon64<T> const& a1, T a2)
+	{
+		return vmls(a0, a1, vdup_n<neon64<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<T>
+		vmls_lane(neon128<T> const& a0, neon128<T> const& a1, V const& a2)
+	{
+		return vmls(a0, a1, vdup_lane<Lane, neon128<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon64<T>
+		vmls_lane(neon64<T> const& a0, neon64<T> const& a1, V const& a2)
+	{
+		return vmls(a0, a1, vdup_lane<Lane, neon64<T>>(a2));
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmlsl_n(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1, T a2)
+	{
+		return vmlsl(a0, a1, vdup_n<neon64<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<typename neon_type<T>::wide_type>
+		vmlsl_lane(neon128<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1, V const& a2)
+	{
+		return vmlsl(a0, a1, vdup_lane<Lane, neon64<T>>(a2));
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmlsl_high_n(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1, T a2)
+	{
+		return vmlsl_high(a0, a1, vdup_n<neon128<T>>(a2));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<typename neon_type<T>::wide_type>
+		vmlsl_high_lane(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1, V const& a2)
+	{
+		return vmlsl_high(a0, a1, vdup_lane<Lane, neon128<T>>(a2));
+	}
+
+	template <typename T>
+	neon128<T>
+		vmul_n(neon128<T> const& a0, T a1)
+	{
+		return vmul(a0, vdup_n<neon128<T>>(a1));
+	}
+
+	template <typename T>
+	neon64<T>
+		vmul_n(neon64<T> const& a0, T a1)
+	{
+		return vmul(a0, vdup_n<neon64<T>>(a1));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<T>
+		vmul_lane(neon128<T> const& a0, V const& a1)
+	{
+		return vmul(a0, vdup_lane<Lane, neon128<T>>(a1));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon64<T>
+		vmul_lane(neon64<T> const& a0, V const& a1)
+	{
+		return vmul(a0, vdup_lane<Lane, neon64<T>>(a1));
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmull_n(neon64<T> const& a0, T a1)
+	{
+		return vmull(a0, vdup_n<neon64<T>>(a1));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<typename neon_type<T>::wide_type>
+		vmull_lane(neon64<T> const& a0, V const& a1)
+	{
+		return vmull(a0, vdup_lane<Lane, neon64<T>>(a1));
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmull_high_n(neon128<T> const& a0, T a1)
+	{
+		return vmull_high(a0, vdup_n<neon128<T>>(a1));
+	}
+
+	template <int Lane, typename T, typename V>
+	neon128<typename neon_type<T>::wide_type>
+		vmull_high_lane(neon128<T> const& a0, V const& a1)
+	{
+		return vmull_high(a0, vdup_lane<Lane, neon128<T>>(a1));
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmovl(neon64<T> const& a)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wide_type(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vmovl_high(neon128<T> const& a)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wide_type(a.v_[neon128<wide_type>::N + i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<typename neon_type<T>::narrow_type>
+		vmovn(neon128<T> const& a)
+	{
+		using narrow_type = typename neon_type<T>::narrow_type;
+
+		neon64<narrow_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = narrow_type(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::narrow_type>
+		vmovn_high(neon64<typename neon_type<T>::narrow_type> const& a0, neon128<T> const& a1)
+	{
+		using narrow_type = typename neon_type<T>::narrow_type;
+
+		neon128<narrow_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+		{
+			r.v_[i] = a0.v_[i];
+			r.v_[neon128<T>::N + i] = narrow_type(a1.v_[i]);
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vmvn(neon128<T> const& a)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = ~a.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vmvn(neon64<T> const& a)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = ~a.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vorn(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] | ~a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vorn(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] | ~a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vorr(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = a0.v_[i] | a1.v_[i];
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vorr(neon64<T> const& a0, neon64<T> const& a1)
+	{
 		neon64<T> r;
 		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = a0.v_[i] | a1.v_[i];
+		return r;
+	}
+
+	// Pairwise ops: adjacent lanes of a0 fill the low half of the result and
+	// adjacent lanes of a1 the high half.
+	template <typename T>
+	neon128<T>
+		vpadd(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		constexpr int half = neon128<T>::N / 2;
+
+		neon128<T> r;
+		for (int i = 0; i < half; i++)
 		{
-			r.v_[i] = a0.v_[i] ^ (a1.v_[i] & ~a2.v_[i]);
+			r.v_[i] = wrap_add(a0.v_[2 * i], a0.v_[2 * i + 1]);
+			r.v_[half + i] = wrap_add(a1.v_[2 * i], a1.v_[2 * i + 1]);
 		}
 		return r;
 	}
 
-	
-	template <typename T, typename = void>
-	struct cmptype {};
+	template <typename T>
+	neon64<T>
+		vpadd(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		constexpr int half = neon64<T>::N / 2;
 
-	template <typename T> 
-	struct cmptype<T, typename std::enable_if<std::is_integral<T>::value>::type>
-	{ using type = typename std::make_unsigned<T>::type; };
-	
-	template <typename T> 
-	struct cmptype<T, typename std::enable_if<is_ieee754<T>::value>::type> 
-	{ using type = typename ieee754<T>::itype; };
+		neon64<T> r;
+		for (int i = 0; i < half; i++)
+		{
+			r.v_[i] = wrap_add(a0.v_[2 * i], a0.v_[2 * i + 1]);
+			r.v_[half + i] = wrap_add(a1.v_[2 * i], a1.v_[2 * i + 1]);
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vpaddl(neon128<T> const& a)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
 
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wide_type(wide_type(a.v_[2 * i]) + wide_type(a.v_[2 * i + 1]));
+		return r;
+	}
 
 	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vceq(neon128<T> const& a0, neon128<T> const& a1)
+	neon64<typename neon_type<T>::wide_type>
+		vpaddl(neon64<T> const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-	
-		neon128<mask_type> r;
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon64<wide_type> r;
+		for (int i = 0; i < neon64<wide_type>::N; i++)
+			r.v_[i] = wide_type(wide_type(a.v_[2 * i]) + wide_type(a.v_[2 * i + 1]));
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::wide_type>
+		vpadal(neon128<typename neon_type<T>::wide_type> const& a0, neon128<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon128<wide_type> r;
+		for (int i = 0; i < neon128<wide_type>::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], wide_type(wide_type(a1.v_[2 * i]) + wide_type(a1.v_[2 * i + 1])));
+		return r;
+	}
+
+	template <typename T>
+	neon64<typename neon_type<T>::wide_type>
+		vpadal(neon64<typename neon_type<T>::wide_type> const& a0, neon64<T> const& a1)
+	{
+		using wide_type = typename neon_type<T>::wide_type;
+
+		neon64<wide_type> r;
+		for (int i = 0; i < neon64<wide_type>::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], wide_type(wide_type(a1.v_[2 * i]) + wide_type(a1.v_[2 * i + 1])));
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vqabs(neon128<T> const& a)
+	{
+		neon128<T> r;
 		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a0.v_[i] == a1.v_[i] ? mask_type(-1) : mask_type(0);
+			r.v_[i] = sat_abs(a.v_[i]);
 		return r;
 	}
-	
 
 	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vceq(neon64<T> const& a0, neon64<T> const& a1)
+	neon64<T>
+		vqabs(neon64<T> const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = sat_abs(a.v_[i]);
+		return r;
+	}
 
-		neon64<mask_type> r;
+	template <typename T>
+	neon128<T>
+		vqadd(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = sat_add(a0.v_[i], a1.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vqadd(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
 		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a0.v_[i] == a1.v_[i] ? mask_type(-1) : mask_type(0);
+			r.v_[i] = sat_add(a0.v_[i], a1.v_[i]);
 		return r;
 	}
 
 	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vceqz(neon128<T> const& a)
+	neon128<T>
+		vqdmulh(neon128<T> const& a0, neon128<T> const& a1)
 	{
-		using mask_type = typename cmptype<T>::type;
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = sat_doubling_mulh<false>(a0.v_[i], a1.v_[i]);
+		return r;
+	}
 
-		neon128<mask_type> r;
+	template <typename T>
+	neon64<T>
+		vqdmulh(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = sat_doubling_mulh<false>(a0.v_[i], a1.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<typename neon_type<T>::narrow_type>
+		vqmovn(neon128<T> const& a)
+	{
+		using narrow_type = typename neon_type<T>::narrow_type;
+
+		neon64<narrow_type> r;
 		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a.v_[i] == T(0) ? mask_type(-1) : mask_type(0);
+			r.v_[i] = sat_narrow<narrow_type>(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<typename neon_type<T>::narrow_type>
+		vqmovn_high(neon64<typename neon_type<T>::narrow_type> const& a0, neon128<T> const& a1)
+	{
+		using narrow_type = typename neon_type<T>::narrow_type;
+
+		neon128<narrow_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+		{
+			r.v_[i] = a0.v_[i];
+			r.v_[neon128<T>::N + i] = sat_narrow<narrow_type>(a1.v_[i]);
+		}
+		return r;
+	}
+
+	// Signed to unsigned: negative lanes saturate to 0.
+	template <typename T>
+	typename std::enable_if<std::is_signed<T>::value, neon64<typename std::make_unsigned<typename neon_type<T>::narrow_type>::type>>::type
+		vqmovun(neon128<T> const& a)
+	{
+		using narrow_type = typename std::make_unsigned<typename neon_type<T>::narrow_type>::type;
+
+		neon64<narrow_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = sat_narrow<narrow_type>(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	typename std::enable_if<std::is_signed<T>::value, neon128<typename std::make_unsigned<typename neon_type<T>::narrow_type>::type>>::type
+		vqmovun_high(neon64<typename std::make_unsigned<typename neon_type<T>::narrow_type>::type> const& a0, neon128<T> const& a1)
+	{
+		using narrow_type = typename std::make_unsigned<typename neon_type<T>::narrow_type>::type;
+
+		neon128<narrow_type> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+		{
+			r.v_[i] = a0.v_[i];
+			r.v_[neon128<T>::N + i] = sat_narrow<narrow_type>(a1.v_[i]);
+		}
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vqneg(neon128<T> const& a)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = sat_neg(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vqneg(neon64<T> const& a)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = sat_neg(a.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vqrdmulh(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = sat_doubling_mulh<true>(a0.v_[i], a1.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vqrdmulh(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = sat_doubling_mulh<true>(a0.v_[i], a1.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon128<T>
+		vqsub(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+			r.v_[i] = sat_sub(a0.v_[i], a1.v_[i]);
+		return r;
+	}
+
+	template <typename T>
+	neon64<T>
+		vqsub(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+			r.v_[i] = sat_sub(a0.v_[i], a1.v_[i]);
+		return r;
+	}
+
+	// Shifts by a register of per-lane counts, see shift_count.
+	template <typename T, typename C>
+	neon128<T>
+		vshl(neon128<T> const& a0, neon128<C> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+		{
+			int n = shift_count(a1.v_[i]);
+			r.v_[i] = n >= 0 ? shift_left(a0.v_[i], n) : shift_right(a0.v_[i], -n);
+		}
+		return r;
+	}
+
+	template <typename T, typename C>
+	neon64<T>
+		vshl(neon64<T> const& a0, neon64<C> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+		{
+			int n = shift_count(a1.v_[i]);
+			r.v_[i] = n >= 0 ? shift_left(a0.v_[i], n) : shift_right(a0.v_[i], -n);
+		}
+		return r;
+	}
+
+	template <typename T, typename C>
+	neon128<T>
+		vrshl(neon128<T> const& a0, neon128<C> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+		{
+			int n = shift_count(a1.v_[i]);
+			r.v_[i] = n >= 0 ? shift_left(a0.v_[i], n) : rounding_shift_right(a0.v_[i], -n);
+		}
+		return r;
+	}
+
+	template <typename T, typename C>
+	neon64<T>
+		vrshl(neon64<T> const& a0, neon64<C> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+		{
+			int n = shift_count(a1.v_[i]);
+			r.v_[i] = n >= 0 ? shift_left(a0.v_[i], n) : rounding_shift_right(a0.v_[i], -n);
+		}
+		return r;
+	}
+
+	template <typename T, typename C>
+	neon128<T>
+		vqshl(neon128<T> const& a0, neon128<C> const& a1)
+	{
+		neon128<T> r;
+		for (int i = 0; i < neon128<T>::N; i++)
+		{
+			int n = shift_count(a1.v_[i]);
+			r.v_[i] = n >= 0 ? sat_shift_left(a0.v_[i], n) : shift_right(a0.v_[i], -n);
+		}
+		return r;
+	}
+
+	template <typename T, typename C>
+	neon64<T>
+		vqshl(neon64<T> const& a0, neon64<C> const& a1)
+	{
+		neon64<T> r;
+		for (int i = 0; i < neon64<T>::N; i++)
+		{
+			int n = shift_count(a1.v_[i]);
+			r.v_[i] = n >= 0 ? sat_shift_left(a0.v_[i], n) : shift_right(a0.v_[i], -n);
+		}
 		return r;
 	}
 
-
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vceqz(neon64<T> const& a)
+	// Shifts by an immediate, which like the lane indexes is a template
+	// parameter: the api's vshl_n_s16(a, n) is the macro neon::vshl_n<n>(a).
+	template <int N, typename V>
+	V
+		vshl_n(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a.v_[i] == T(0) ? mask_type(-1) : mask_type(0);
+		static_assert(left_shift<typename V::type>(N), "shift out of range");
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = shift_left(a.v_[i], N);
 		return r;
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcge(neon128<T> const& a0, neon128<T> const& a1)
+	template <int N, typename V>
+	V
+		vshr_n(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a0.v_[i] >= a1.v_[i] ? mask_type(-1) : mask_type(0);
+		static_assert(right_shift<typename V::type>(N), "shift out of range");
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = shift_right(a.v_[i], N);
 		return r;
 	}
 
-
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcge(neon64<T> const& a0, neon64<T> const& a1)
+	template <int N, typename V>
+	V
+		vrshr_n(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a0.v_[i] >= a1.v_[i] ? mask_type(-1) : mask_type(0);
+		static_assert(right_shift<typename V::type>(N), "shift out of range");
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = rounding_shift_right(a.v_[i], N);
 		return r;
 	}
 
+	template <int N, typename V>
+	V
+		vsra_n(V const& a0, V const& a1)
+	{
+		static_assert(right_shift<typename V::type>(N), "shift out of range");
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], shift_right(a1.v_[i], N));
+		return r;
+	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcgez(neon128<T> const& a)
+	template <int N, typename V>
+	V
+		vrsra_n(V const& a0, V const& a1)
 	{
-		using mask_type = typename cmptype<T>::type;
+		static_assert(right_shift<typename V::type>(N), "shift out of range");
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = wrap_add(a0.v_[i], rounding_shift_right(a1.v_[i], N));
+		return r;
+	}
 
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a.v_[i] >= T(0) ? mask_type(-1) : mask_type(0);
+	// Shift and insert: the bits shifted in come from a0 rather than zero.
+	template <int N, typename V>
+	V
+		vsli_n(V const& a0, V const& a1)
+	{
+		using T = typename V::type;
+		using U = typename std::make_unsigned<T>::type;
+		static_assert(left_shift<T>(N), "shift out of range");
+		const U keep = U(~shift_left(U(~U(0)), N));
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = T(shift_left(U(a1.v_[i]), N) | (U(a0.v_[i]) & keep));
 		return r;
 	}
 
+	template <int N, typename V>
+	V
+		vsri_n(V const& a0, V const& a1)
+	{
+		using T = typename V::type;
+		using U = typename std::make_unsigned<T>::type;
+		static_assert(right_shift<T>(N), "shift out of range");
+		const U keep = U(~shift_right(U(~U(0)), N));
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = T(shift_right(U(a1.v_[i]), N) | (U(a0.v_[i]) & keep));
+		return r;
+	}
 
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcgez(neon64<T> const& a)
+	// Narrowing shifts right: a q register of T to a d register of its
+	// narrow type, the immediate ranging up to the narrow width.
+	template <int N, typename V>
+	neon64<typename neon_type<typename V::type>::narrow_type>
+		vshrn_n(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a.v_[i] >= 0 ? mask_type(-1) : mask_type(0);
+		using narrow_type = typename neon_type<typename V::type>::narrow_type;
+		static_assert(right_shift<narrow_type>(N), "shift out of range");
+		neon64<narrow_type> r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = narrow_type(shift_right(a.v_[i], N));
 		return r;
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcle(neon128<T> const& a0, neon128<T> const& a1)
+	template <int N, typename V>
+	neon64<typename neon_type<typename V::type>::narrow_type>
+		vrshrn_n(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a0.v_[i] <= a1.v_[i] ? mask_type(-1) : mask_type(0);
+		using narrow_type = typename neon_type<typename V::type>::narrow_type;
+		static_assert(right_shift<narrow_type>(N), "shift out of range");
+		neon64<narrow_type> r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = narrow_type(rounding_shift_right(a.v_[i], N));
 		return r;
 	}
 
-
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcle(neon64<T> const& a0, neon64<T> const& a1)
+	template <int N, typename V>
+	neon64<typename neon_type<typename V::type>::narrow_type>
+		vqshrn_n(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a0.v_[i] <= a1.v_[i] ? mask_type(-1) : mask_type(0);
+		using narrow_type = typename neon_type<typename V::type>::narrow_type;
+		static_assert(right_shift<narrow_type>(N), "shift out of range");
+		neon64<narrow_type> r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = sat_narrow<narrow_type>(shift_right(a.v_[i], N));
 		return r;
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vclez(neon128<T> const& a)
+	template <int N, typename V>
+	neon64<typename neon_type<typename V::type>::narrow_type>
+		vqrshrn_n(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a.v_[i] <= T(0) ? mask_type(-1) : mask_type(0);
+		using narrow_type = typename neon_type<typename V::type>::narrow_type;
+		static_assert(right_shift<narrow_type>(N), "shift out of range");
+		neon64<narrow_type> r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = sat_narrow<narrow_type>(rounding_shift_right(a.v_[i], N));
 		return r;
 	}
 
-
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vclez(neon64<T> const& a)
+	template <typename V>
+	void
+		vst1(typename V::type* p, V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
+		std::memcpy(p, &a.v_, sizeof(a.v_));
+	}
 
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a.v_[i] <= 0 ? mask_type(-1) : mask_type(0);
-		return r;
+	template <typename V, size_t Count>
+	void
+		vst1_x(typename V::type* p, neon_tuple<V, Count> const& a)
+	{
+		for (size_t i = 0; i < Count; i++)
+			std::memcpy(p + i * V::N, &a.val[i].v_, sizeof(a.val[i].v_));
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcgt(neon128<T> const& a0, neon128<T> const& a1)
+	template <int Lane, typename V>
+	void
+		vst1_lane(typename V::type* p, V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
+		static_assert(Lane >= 0 && Lane < V::N, "lane out of range");
 
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a0.v_[i] > a1.v_[i] ? mask_type(-1) : mask_type(0);
-		return r;
+		*p = a.v_[Lane];
 	}
 
+	template <typename V, size_t Count>
+	void
+		vstn(typename V::type* p, neon_tuple<V, Count> const& a)
+	{
+		for (int i = 0; i < V::N; i++)
+			for (size_t j = 0; j < Count; j++)
+				p[i * Count + j] = a.val[j].v_[i];
+	}
 
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcgt(neon64<T> const& a0, neon64<T> const& a1)
+	template <int Lane, typename V, size_t Count>
+	void
+		vstn_lane(typename V::type* p, neon_tuple<V, Count> const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
+		static_assert(Lane >= 0 && Lane < V::N, "lane out of range");
 
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a0.v_[i] > a1.v_[i] ? mask_type(-1) : mask_type(0);
-		return r;
+		for (size_t j = 0; j < Count; j++)
+			p[j] = a.val[j].v_[Lane];
 	}
 
-
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcgtz(neon128<T> const& a)
+	// Table lookups over Count d registers (vtbl/vtbx) or q registers
+	// (vqtbl/vqtbx) of bytes. Indices past the end of the table give 0 for
+	// vtbl and keep the byte of a0 for vtbx.
+	template <typename V, size_t Count, typename U>
+	typename V::type
+		table_byte(neon_tuple<V, Count> const& t, U index, typename V::type fallback)
 	{
-		using mask_type = typename cmptype<T>::type;
+		size_t i = typename std::make_unsigned<U>::type(index);
+		return i < Count * V::N ? t.val[i / V::N].v_[i % V::N] : fallback;
+	}
 
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a.v_[i] > T(0) ? mask_type(-1) : mask_type(0);
+	template <typename V, size_t Count, typename U>
+	neon128<typename V::type>
+		vtbl(neon_tuple<V, Count> const& a0, neon128<U> const& a1)
+	{
+		neon128<typename V::type> r;
+		for (int i = 0; i < neon128<U>::N; i++)
+			r.v_[i] = table_byte(a0, a1.v_[i], typename V::type(0));
 		return r;
 	}
 
-
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcgtz(neon64<T> const& a)
+	template <typename V, size_t Count, typename U>
+	neon64<typename V::type>
+		vtbl(neon_tuple<V, Count> const& a0, neon64<U> const& a1)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a.v_[i] > 0 ? mask_type(-1) : mask_type(0);
+		neon64<typename V::type> r;
+		for (int i = 0; i < neon64<U>::N; i++)
+			r.v_[i] = table_byte(a0, a1.v_[i], typename V::type(0));
 		return r;
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vclt(neon128<T> const& a0, neon128<T> const& a1)
+	template <typename V, size_t Count, typename U>
+	neon128<typename V::type>
+		vtbx(neon128<typename V::type> const& a0, neon_tuple<V, Count> const& a1, neon128<U> const& a2)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a0.v_[i] < a1.v_[i] ? mask_type(-1) : mask_type(0);
+		neon128<typename V::type> r;
+		for (int i = 0; i < neon128<U>::N; i++)
+			r.v_[i] = table_byte(a1, a2.v_[i], a0.v_[i]);
 		return r;
 	}
 
-
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vclt(neon64<T> const& a0, neon64<T> const& a1)
+	template <typename V, size_t Count, typename U>
+	neon64<typename V::type>
+		vtbx(neon64<typename V::type> const& a0, neon_tuple<V, Count> const& a1, neon64<U> const& a2)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a0.v_[i] < a1.v_[i] ? mask_type(-1) : mask_type(0);
+		neon64<typename V::type> r;
+		for (int i = 0; i < neon64<U>::N; i++)
+			r.v_[i] = table_byte(a1, a2.v_[i], a0.v_[i]);
 		return r;
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcltz(neon128<T> const& a)
+	// Permutations. zip interleaves the low (1) or high (2) halves of a0 and
+	// a1, uzp takes their even (1) or odd (2) lanes, trn the even or odd lane
+	// of each pair; the ARMv7 vzip/vuzp/vtrn return both halves as a pair.
+	template <typename V>
+	V
+		zip_half(V const& a0, V const& a1, int part)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = a.v_[i] < T(0) ? mask_type(-1) : mask_type(0);
+		constexpr int half = V::N / 2;
+		V r;
+		for (int i = 0; i < half; i++)
+		{
+			r.v_[2 * i] = a0.v_[part * half + i];
+			r.v_[2 * i + 1] = a1.v_[part * half + i];
+		}
 		return r;
 	}
 
-
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcltz(neon64<T> const& a)
+	template <typename V>
+	V
+		uzp_half(V const& a0, V const& a1, int part)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = a.v_[i] < 0 ? mask_type(-1) : mask_type(0);
+		constexpr int half = V::N / 2;
+		V r;
+		for (int i = 0; i < half; i++)
+		{
+			r.v_[i] = a0.v_[2 * i + part];
+			r.v_[half + i] = a1.v_[2 * i + part];
+		}
 		return r;
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcage(neon128<T> const& a0, neon128<T> const& a1)
+	template <typename V>
+	V
+		trn_half(V const& a0, V const& a1, int part)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i]) >= std::abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		V r;
+		for (int i = 0; i < V::N; i += 2)
+		{
+			r.v_[i] = a0.v_[i + part];
+			r.v_[i + 1] = a1.v_[i + part];
+		}
 		return r;
 	}
 
+	template <typename V>
+	V
+		vzip1(V const& a0, V const& a1)
+	{
+		return zip_half(a0, a1, 0);
+	}
 
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcage(neon64<T> const& a0, neon64<T> const& a1)
+	template <typename V>
+	V
+		vzip2(V const& a0, V const& a1)
 	{
-		using mask_type = typename cmptype<T>::type;
+		return zip_half(a0, a1, 1);
+	}
 
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i]) >= std::abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
-		return r;
+	template <typename V>
+	neon_tuple<V, 2>
+		vzip(V const& a0, V const& a1)
+	{
+		return { { zip_half(a0, a1, 0), zip_half(a0, a1, 1) } };
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcale(neon128<T> const& a0, neon128<T> const& a1)
+	template <typename V>
+	V
+		vuzp1(V const& a0, V const& a1)
 	{
-		using mask_type = typename cmptype<T>::type;
+		return uzp_half(a0, a1, 0);
+	}
 
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i]) <= std::abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
-		return r;
+	template <typename V>
+	V
+		vuzp2(V const& a0, V const& a1)
+	{
+		return uzp_half(a0, a1, 1);
 	}
 
+	template <typename V>
+	neon_tuple<V, 2>
+		vuzp(V const& a0, V const& a1)
+	{
+		return { { uzp_half(a0, a1, 0), uzp_half(a0, a1, 1) } };
+	}
 
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcale(neon64<T> const& a0, neon64<T> const& a1)
+	template <typename V>
+	V
+		vtrn1(V const& a0, V const& a1)
 	{
-		using mask_type = typename cmptype<T>::type;
+		return trn_half(a0, a1, 0);
+	}
 
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i]) <= std::abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
-		return r;
+	template <typename V>
+	V
+		vtrn2(V const& a0, V const& a1)
+	{
+		return trn_half(a0, a1, 1);
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcagt(neon128<T> const& a0, neon128<T> const& a1)
+	template <typename V>
+	neon_tuple<V, 2>
+		vtrn(V const& a0, V const& a1)
 	{
-		using mask_type = typename cmptype<T>::type;
+		return { { trn_half(a0, a1, 0), trn_half(a0, a1, 1) } };
+	}
 
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i]) > std::abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+	// Lanes N and up of a0 followed by the low lanes of a1; N is an immediate,
+	// so the api's vext_u8(a0, a1, n) is a macro like the shifts.
+	template <int N, typename V>
+	V
+		vext(V const& a0, V const& a1)
+	{
+		static_assert(N >= 0 && N < V::N, "lane out of range");
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = i + N < V::N ? a0.v_[i + N] : a1.v_[i + N - V::N];
 		return r;
 	}
 
-
-	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcagt(neon64<T> const& a0, neon64<T> const& a1)
+	// Lane order reversed within each Bits-wide group.
+	template <size_t Bits, typename V>
+	V
+		reverse_lanes(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i]) > std::abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		constexpr int group = Bits / 8 / sizeof(typename V::type);
+		static_assert(group > 1, "lanes as wide as the group");
+		V r;
+		for (int i = 0; i < V::N; i++)
+			r.v_[i] = a.v_[i ^ (group - 1)];
 		return r;
 	}
 
-	template <typename T>
-	neon128<typename cmptype<T>::type>
-		vcalt(neon128<T> const& a0, neon128<T> const& a1)
+	template <typename V>
+	V
+		vrev16(V const& a)
 	{
-		using mask_type = typename cmptype<T>::type;
+		return reverse_lanes<16>(a);
+	}
 
-		neon128<mask_type> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i]) < std::abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
-		return r;
+	template <typename V>
+	V
+		vrev32(V const& a)
+	{
+		return reverse_lanes<32>(a);
 	}
 
+	template <typename V>
+	V
+		vrev64(V const& a)
+	{
+		return reverse_lanes<64>(a);
+	}
 
+	// A q register is its two d registers back to back, so splitting and
+	// joining them are plain copies, which compile to register moves.
 	template <typename T>
-	neon64<typename cmptype<T>::type>
-		vcalt(neon64<T> const& a0, neon64<T> const& a1)
+	neon128<T>
+		vcombine(neon64<T> const& a0, neon64<T> const& a1)
 	{
-		using mask_type = typename cmptype<T>::type;
-
-		neon64<mask_type> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = std::abs(a0.v_[i]) < std::abs(a1.v_[i]) ? mask_type(-1) : mask_type(0);
+		neon128<T> r;
+		std::memcpy(&r, &a0, sizeof(a0));
+		std::memcpy(reinterpret_cast<char*>(&r) + sizeof(a0), &a1, sizeof(a1));
 		return r;
 	}
 
-	template <typename OUTT, typename T>
-	neon64<OUTT>
-		vcvt(neon64<T> const& a)
+	template <typename T>
+	neon64<T>
+		vget_low(neon128<T> const& a)
 	{
-		neon64<OUTT> r;
-		for (int i = 0; i < neon64<T>::N; i++)
-			r.v_[i] = OUTT(a.v_[i]);
+		neon64<T> r;
+		std::memcpy(&r, &a, sizeof(r));
 		return r;
 	}
 
-	template <typename OUTT, typename T>
-	neon128<OUTT>
-		vcvt(neon128<T> const& a)
+	template <typename T>
+	neon64<T>
+		vget_high(neon128<T> const& a)
 	{
-		neon128<OUTT> r;
-		for (int i = 0; i < neon128<T>::N; i++)
-			r.v_[i] = OUTT(a.v_[i]);
+		neon64<T> r;
+		std::memcpy(&r, reinterpret_cast<char const*>(&a) + sizeof(r), sizeof(r));
 		return r;
 	}
 
 } // namesoace neon
 
+#include "neon_x86.h"
+
+
+// Next to arm_neon.h (NEON_NATIVE) the emulated types keep out of the way of
+// the native ones.
+#if defined(NEON_NATIVE)
+namespace neon { namespace emulated {
+#endif
 
 using int8x8_t = neon::neon64<int8_t>;
 using uint8x8_t = neon::neon64<uint8_t>;
@@ -894,3 +3042,75 @@ using float32x4_t = neon::neon128<float32_t>;
 using float64x1_t = neon::neon64<float64_t>;
 using float64x2_t = neon::neon128<float64_t>;
 
+using int8x8x2_t = neon::neon_tuple<int8x8_t, 2>;
+using int8x16x2_t = neon::neon_tuple<int8x16_t, 2>;
+using uint8x8x2_t = neon::neon_tuple<uint8x8_t, 2>;
+using uint8x16x2_t = neon::neon_tuple<uint8x16_t, 2>;
+using int16x4x2_t = neon::neon_tuple<int16x4_t, 2>;
+using int16x8x2_t = neon::neon_tuple<int16x8_t, 2>;
+using uint16x4x2_t = neon::neon_tuple<uint16x4_t, 2>;
+using uint16x8x2_t = neon::neon_tuple<uint16x8_t, 2>;
+using int32x2x2_t = neon::neon_tuple<int32x2_t, 2>;
+using int32x4x2_t = neon::neon_tuple<int32x4_t, 2>;
+using uint32x2x2_t = neon::neon_tuple<uint32x2_t, 2>;
+using uint32x4x2_t = neon::neon_tuple<uint32x4_t, 2>;
+using int64x1x2_t = neon::neon_tuple<int64x1_t, 2>;
+using int64x2x2_t = neon::neon_tuple<int64x2_t, 2>;
+using uint64x1x2_t = neon::neon_tuple<uint64x1_t, 2>;
+using uint64x2x2_t = neon::neon_tuple<uint64x2_t, 2>;
+using float16x4x2_t = neon::neon_tuple<float16x4_t, 2>;
+using float16x8x2_t = neon::neon_tuple<float16x8_t, 2>;
+using float32x2x2_t = neon::neon_tuple<float32x2_t, 2>;
+using float32x4x2_t = neon::neon_tuple<float32x4_t, 2>;
+using float64x1x2_t = neon::neon_tuple<float64x1_t, 2>;
+using float64x2x2_t = neon::neon_tuple<float64x2_t, 2>;
+
+using int8x8x3_t = neon::neon_tuple<int8x8_t, 3>;
+using int8x16x3_t = neon::neon_tuple<int8x16_t, 3>;
+using uint8x8x3_t = neon::neon_tuple<uint8x8_t, 3>;
+using uint8x16x3_t = neon::neon_tuple<uint8x16_t, 3>;
+using int16x4x3_t = neon::neon_tuple<int16x4_t, 3>;
+using int16x8x3_t = neon::neon_tuple<int16x8_t, 3>;
+using uint16x4x3_t = neon::neon_tuple<uint16x4_t, 3>;
+using uint16x8x3_t = neon::neon_tuple<uint16x8_t, 3>;
+using int32x2x3_t = neon::neon_tuple<int32x2_t, 3>;
+using int32x4x3_t = neon::neon_tuple<int32x4_t, 3>;
+using uint32x2x3_t = neon::neon_tuple<uint32x2_t, 3>;
+using uint32x4x3_t = neon::neon_tuple<uint32x4_t, 3>;
+using int64x1x3_t = neon::neon_tuple<int64x1_t, 3>;
+using int64x2x3_t = neon::neon_tuple<int64x2_t, 3>;
+using uint64x1x3_t = neon::neon_tuple<uint64x1_t, 3>;
+using uint64x2x3_t = neon::neon_tuple<uint64x2_t, 3>;
+using float16x4x3_t = neon::neon_tuple<float16x4_t, 3>;
+using float16x8x3_t = neon::neon_tuple<float16x8_t, 3>;
+using float32x2x3_t = neon::neon_tuple<float32x2_t, 3>;
+using float32x4x3_t = neon::neon_tuple<float32x4_t, 3>;
+using float64x1x3_t = neon::neon_tuple<float64x1_t, 3>;
+using float64x2x3_t = neon::neon_tuple<float64x2_t, 3>;
+
+using int8x8x4_t = neon::neon_tuple<int8x8_t, 4>;
+using int8x16x4_t = neon::neon_tuple<int8x16_t, 4>;
+using uint8x8x4_t = neon::neon_tuple<uint8x8_t, 4>;
+using uint8x16x4_t = neon::neon_tuple<uint8x16_t, 4>;
+using int16x4x4_t = neon::neon_tuple<int16x4_t, 4>;
+using int16x8x4_t = neon::neon_tuple<int16x8_t, 4>;
+using uint16x4x4_t = neon::neon_tuple<uint16x4_t, 4>;
+using uint16x8x4_t = neon::neon_tuple<uint16x8_t, 4>;
+using int32x2x4_t = neon::neon_tuple<int32x2_t, 4>;
+using int32x4x4_t = neon::neon_tuple<int32x4_t, 4>;
+using uint32x2x4_t = neon::neon_tuple<uint32x2_t, 4>;
+using uint32x4x4_t = neon::neon_tuple<uint32x4_t, 4>;
+using int64x1x4_t = neon::neon_tuple<int64x1_t, 4>;
+using int64x2x4_t = neon::neon_tuple<int64x2_t, 4>;
+using uint64x1x4_t = neon::neon_tuple<uint64x1_t, 4>;
+using uint64x2x4_t = neon::neon_tuple<uint64x2_t, 4>;
+using float16x4x4_t = neon::neon_tuple<float16x4_t, 4>;
+using float16x8x4_t = neon::neon_tuple<float16x8_t, 4>;
+using float32x2x4_t = neon::neon_tuple<float32x2_t, 4>;
+using float32x4x4_t = neon::neon_tuple<float32x4_t, 4>;
+using float64x1x4_t = neon::neon_tuple<float64x1_t, 4>;
+using float64x2x4_t = neon::neon_tuple<float64x2_t, 4>;
+
+#if defined(NEON_NATIVE)
+} } // namespace neon::emulated
+#endif
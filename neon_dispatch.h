@@ -0,0 +1,97 @@
+#pragma once
+
+// Runtime backend selection for the generated api (api.py --dispatch).
+//
+// The x86 kernels are compiled once per backend into neon::sse42, neon::avx2
+// and neon::avx512 under GCC target pragmas, next to neon::scalar which only
+// sees the reference templates. Every api function switches on backend(),
+// which is resolved once from cpuid and can be lowered for a run by setting
+// NEON_FORCE_BACKEND to scalar, sse42, avx2 or avx512. Forcing a backend the
+// host can't run falls back to the detected one.
+
+#if !defined(__GNUC__) || defined(__clang__)
+#error "NEON_RUNTIME_DISPATCH relies on GCC target pragmas"
+#endif
+
+#include <cpuid.h>
+#include <cstdlib>
+#include <cstring>
+// Pulled in here, outside the target pragmas, so the intrinsics keep the
+// caller's target rather than the first backend's.
+#include <immintrin.h>
+
+#define NEON_DISPATCH_BEGIN_SSE42 _Pragma("GCC push_options") _Pragma("GCC target(\"sse4.2\")")
+#define NEON_DISPATCH_BEGIN_AVX2 _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,fma,f16c\")")
+#define NEON_DISPATCH_BEGIN_AVX512 _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,fma,f16c,avx512f,avx512bw,avx512vl\")")
+#define NEON_DISPATCH_END _Pragma("GCC pop_options")
+
+// An expression, so the api fronts can hand it to NEON_PROFILE_CALL and
+// NEON_TRACE_CALL like any other call.
+#define NEON_DISPATCH(name, ...) \
+	[&]() -> decltype(auto) { \
+		switch (neon::dispatch::backend()) \
+		{ \
+		case NEON_BACKEND_AVX512: return neon::avx512::name(__VA_ARGS__); \
+		case NEON_BACKEND_AVX2: return neon::avx2::name(__VA_ARGS__); \
+		case NEON_BACKEND_SSE42: return neon::sse42::name(__VA_ARGS__); \
+		default: return neon::scalar::name(__VA_ARGS__); \
+		} \
+	}()
+
+namespace neon {
+
+	namespace dispatch {
+
+		// Highest backend whose target string above the host can run, including
+		// the OS saving the ymm/zmm state.
+		inline int detect()
+		{
+			unsigned a, b, c, d;
+			if (!__get_cpuid(1, &a, &b, &c, &d))
+				return NEON_BACKEND_SCALAR;
+
+			const bool sse42 = (c & bit_SSSE3) && (c & bit_SSE4_1) && (c & bit_SSE4_2);
+			if (!sse42)
+				return NEON_BACKEND_SCALAR;
+
+			const bool avx = (c & bit_OSXSAVE) && (c & bit_AVX) && (c & bit_FMA) && (c & bit_F16C);
+			if (!avx)
+				return NEON_BACKEND_SSE42;
+
+			unsigned xcr0, xcr0_high;
+			__asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+			if ((xcr0 & 0x06) != 0x06 || !__get_cpuid_count(7, 0, &a, &b, &c, &d) || !(b & bit_AVX2))
+				return NEON_BACKEND_SSE42;
+
+			const bool avx512 = (xcr0 & 0xe0) == 0xe0 && (b & bit_AVX512F) && (b & bit_AVX512BW) && (b & bit_AVX512VL);
+			return avx512 ? NEON_BACKEND_AVX512 : NEON_BACKEND_AVX2;
+		}
+
+		inline const char* backend_name(int backend)
+		{
+			static const char* const names[] = { "scalar", "sse42", "avx2", "avx512" };
+			return backend >= NEON_BACKEND_SCALAR && backend <= NEON_BACKEND_AVX512 ? names[backend] : nullptr;
+		}
+
+		// -1 for a null or unknown name.
+		inline int parse_backend(const char* name)
+		{
+			for (int i = NEON_BACKEND_SCALAR; name && i <= NEON_BACKEND_AVX512; i++)
+				if (std::strcmp(name, backend_name(i)) == 0)
+					return i;
+			return -1;
+		}
+
+		inline int backend()
+		{
+			static const int selected = [] {
+				int detected = detect();
+				int forced = parse_backend(std::getenv("NEON_FORCE_BACKEND"));
+				return forced >= 0 && forced < detected ? forced : detected;
+			}();
+			return selected;
+		}
+
+	} // namespace dispatch
+
+} // namespace neon
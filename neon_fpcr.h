@@ -0,0 +1,117 @@
+#pragma once
+
+// Floating-point control register (FPCR) of the calling thread.
+//
+// On aarch64 these read and write the real register. Elsewhere the register
+// is emulated: FZ and RMode are mapped onto MXCSR (FTZ and DAZ, RC), so the
+// x86 float ops follow them at no cost, and DN and FZ16, which x86 has no
+// control for, are applied by the api wrappers to the results of float
+// arithmetic (neon::fpcr_result in neon.h). Hosts without MXCSR only get the
+// rounding mode, through fesetround.
+//
+// Set the register through set_fpcr or fpcr_scope rather than writing MXCSR
+// directly, which leaves DN and FZ16 behind. Code that changes the rounding
+// mode should be built with -frounding-math, or the compiler folds constant
+// float expressions to nearest.
+
+#include <cstdint>
+
+#if defined(__aarch64__)
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define NEON_FPCR_MXCSR 1
+#else
+#include <cfenv>
+#endif
+
+namespace neon {
+
+	constexpr uint32_t fpcr_fz16 = 1u << 19;  // flush half-precision denormals to zero
+	constexpr uint32_t fpcr_rmode = 3u << 22; // rounding mode:
+	constexpr uint32_t fpcr_rn = 0u << 22;    //   to nearest, ties to even
+	constexpr uint32_t fpcr_rp = 1u << 22;    //   towards +infinity
+	constexpr uint32_t fpcr_rm = 2u << 22;    //   towards -infinity
+	constexpr uint32_t fpcr_rz = 3u << 22;    //   towards zero
+	constexpr uint32_t fpcr_fz = 1u << 24;    // flush single and double denormals to zero
+	constexpr uint32_t fpcr_dn = 1u << 25;    // NaN results are the default NaN
+
+#if defined(__aarch64__)
+
+	inline uint32_t get_fpcr()
+	{
+		uint64_t fpcr;
+		asm volatile("mrs %0, fpcr" : "=r"(fpcr));
+		return uint32_t(fpcr);
+	}
+
+	inline void set_fpcr(uint32_t fpcr)
+	{
+		asm volatile("msr fpcr, %0" : : "r"(uint64_t(fpcr)));
+	}
+
+#else
+
+	inline uint32_t& fpcr_register()
+	{
+		static thread_local uint32_t fpcr = 0;
+		return fpcr;
+	}
+
+	inline uint32_t get_fpcr()
+	{
+		return fpcr_register();
+	}
+
+	inline void set_fpcr(uint32_t fpcr)
+	{
+		fpcr_register() = fpcr;
+#if defined(NEON_FPCR_MXCSR)
+		// RMode is RN, RP, RM, RZ; RC is nearest, down, up, zero
+		static const unsigned rc[] = { 0x0000, 0x4000, 0x2000, 0x6000 };
+		unsigned csr = _mm_getcsr() & ~0xe040u;
+		if (fpcr & fpcr_fz)
+			csr |= 0x8040; // FTZ, DAZ
+		_mm_setcsr(csr | rc[(fpcr & fpcr_rmode) >> 22]);
+#else
+		static const int modes[] = { FE_TONEAREST, FE_UPWARD, FE_DOWNWARD, FE_TOWARDZERO };
+		std::fesetround(modes[(fpcr & fpcr_rmode) >> 22]);
+#endif
+	}
+
+#endif
+
+	// Sets the FPCR for the lifetime of the scope, then restores the previous
+	// value. Where the FPCR is emulated on MXCSR, the previous MXCSR control
+	// bits are restored as they were, including modes the caller set on MXCSR
+	// directly. Exception flags raised inside the scope are kept.
+	struct fpcr_scope
+	{
+		uint32_t previous;
+#if defined(NEON_FPCR_MXCSR)
+		unsigned previous_csr;
+#endif
+
+		explicit fpcr_scope(uint32_t fpcr)
+			: previous(get_fpcr())
+#if defined(NEON_FPCR_MXCSR)
+			, previous_csr(_mm_getcsr())
+#endif
+		{
+			set_fpcr(fpcr);
+		}
+
+		~fpcr_scope()
+		{
+#if defined(NEON_FPCR_MXCSR)
+			fpcr_register() = previous;
+			_mm_setcsr((previous_csr & ~0x3fu) | (_mm_getcsr() & 0x3fu));
+#else
+			set_fpcr(previous);
+#endif
+		}
+
+		fpcr_scope(fpcr_scope const&) = delete;
+		fpcr_scope& operator=(fpcr_scope const&) = delete;
+	};
+
+} // namespace neon
@@ -0,0 +1,131 @@
+#pragma once
+
+// aarch64 build of the generated api. The api names are the real intrinsics,
+// so int8x16_t, vaddq_u32 and the rest come straight from arm_neon.h and the
+// emulation is not compiled at all; define NEON_EMULATE to use the emulation
+// on aarch64 as well.
+//
+// With NEON_CHECKED the emulation is compiled into neon::emulated next to the
+// native types, and every api function is replaced by a macro running both
+// and comparing the results (stores through the memory they write). The
+// lane and immediate forms become templates on their constant, which they
+// pass on to the intrinsic. A mismatch calls neon::checked::on_mismatch(),
+// which by default prints the intrinsic's name and aborts.
+
+#if !defined(__aarch64__)
+#error "neon_native.h is for aarch64 builds"
+#endif
+
+#define NEON_NATIVE 1
+
+// The intrinsics taking a constant, called from the wrappers of the same name:
+// clang's are macros, GCC's functions the wrapper would otherwise hide.
+#if defined(__clang__)
+#define NEON_NATIVE_INTRINSIC(name) name
+#else
+#define NEON_NATIVE_INTRINSIC(name) ::name
+#endif
+
+#include <arm_neon.h>
+
+#include "neon_fpcr.h"
+
+#if defined(NEON_CHECKED)
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "neon.h"
+
+namespace neon {
+
+	namespace checked {
+
+		inline void (*&on_mismatch())(const char* name)
+		{
+			static void (*handler)(const char*) = [](const char* name) {
+				std::fprintf(stderr, "neon: native %s differs from the emulation\n", name);
+				std::abort();
+			};
+			return handler;
+		}
+
+		template <typename E, typename N>
+		E emulate(N const& a)
+		{
+			static_assert(sizeof(E) == sizeof(N), "emulated and native layouts differ");
+			E r;
+			std::memcpy(&r, &a, sizeof(E));
+			return r;
+		}
+
+		// Lanes are compared bit for bit, except that any NaN matches any NaN:
+		// the emulation only models the default NaN under FPCR.DN.
+		template <typename T>
+		bool same_lane(T a, T b)
+		{
+			if (is_ieee754<T>::value && a != a && b != b)
+				return true;
+			return std::memcmp(&a, &b, sizeof(T)) == 0;
+		}
+
+		template <typename T>
+		bool same(T const& a, T const& b)
+		{
+			return same_lane(a, b);
+		}
+
+		template <typename T>
+		bool same(neon64<T> const& a, neon64<T> const& b)
+		{
+			for (int i = 0; i < int(neon64<T>::N); i++)
+				if (!same_lane(a[i], b[i]))
+					return false;
+			return true;
+		}
+
+		template <typename T>
+		bool same(neon128<T> const& a, neon128<T> const& b)
+		{
+			for (int i = 0; i < int(neon128<T>::N); i++)
+				if (!same_lane(a[i], b[i]))
+					return false;
+			return true;
+		}
+
+		template <typename V, size_t Count>
+		bool same(neon_tuple<V, Count> const& a, neon_tuple<V, Count> const& b)
+		{
+			for (size_t i = 0; i < Count; i++)
+				if (!same(a.val[i], b.val[i]))
+					return false;
+			return true;
+		}
+
+		template <typename N, typename E>
+		N result(const char* name, N native, E const& emulated)
+		{
+			if (!same(emulate<E>(native), emulated))
+				on_mismatch()(name);
+			return native;
+		}
+
+		// Runs the native store on p and the emulated one on a copy of the
+		// bytes p held before, then compares the two.
+		template <typename T, typename Native, typename Emulated>
+		void store(const char* name, T* p, size_t size, Native native, Emulated emulated)
+		{
+			alignas(16) unsigned char copy[64];
+			std::memcpy(copy, p, size);
+			native();
+			emulated(reinterpret_cast<T*>(copy));
+			if (std::memcmp(copy, p, size) != 0)
+				on_mismatch()(name);
+		}
+
+	} // namespace checked
+
+} // namespace neon
+
+#endif
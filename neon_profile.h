@@ -0,0 +1,348 @@
+#pragma once
+
+// Call profiler for the generated api, compiled in with NEON_PROFILE.
+//
+// Every api function opens with NEON_PROFILE_CALL(id), which is empty unless
+// NEON_PROFILE is defined. When it is, calls are counted per function in
+// thread-local counters; NEON_PROFILE_CYCLES also adds the ticks spent in the
+// call (rdtsc on x86, cntvct_el0 on aarch64), the counter's own cost
+// included. A thread adds its counters into the process totals with atomics
+// when it exits, and the totals are written sorted by cost at process exit,
+// to stderr or to the file named by NEON_PROFILE_OUTPUT. Threads still
+// running at exit are not counted.
+//
+// NEON_PROFILE_KERNEL("name") at the top of a block attributes the calls made
+// in it to that kernel (the innermost one when nested). For the whole run and
+// for each kernel the dump then estimates the cycles the same calls would
+// take on the ARM cores of api.py's cost tables: bound by the busiest pipe
+// when the calls are independent, and by the summed latencies when they form
+// one dependency chain. The critical intrinsics are the ones adding the most
+// to the first core's throughput bound.
+//
+// Included by neon_api.h after its function and cost tables.
+
+#if defined(NEON_PROFILE)
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(NEON_PROFILE_CYCLES)
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif !defined(__aarch64__)
+#include <chrono>
+#endif
+#endif
+
+#if !defined(NEON_PROFILE_KERNELS)
+#define NEON_PROFILE_KERNELS 64
+#endif
+
+#define NEON_PROFILE_CALL(id) neon::profile::scope neon_profile_scope_(id);
+#define NEON_PROFILE_KERNEL(name) neon::profile::kernel neon_profile_kernel_([] { static const size_t id = neon::profile::kernel_id(name); return id; }());
+
+namespace neon {
+
+	namespace profile {
+
+		struct counter
+		{
+			uint64_t calls;
+			uint64_t ticks;
+		};
+
+		inline uint64_t ticks()
+		{
+#if !defined(NEON_PROFILE_CYCLES)
+			return 0;
+#elif defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+#elif defined(__aarch64__)
+			uint64_t t;
+			asm volatile("mrs %0, cntvct_el0" : "=r"(t));
+			return t;
+#else
+			return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+
+		inline void dump_calls(FILE* f, std::vector<counter> const& totals)
+		{
+#if defined(NEON_PROFILE_CYCLES)
+			const bool cycles = true;
+#else
+			const bool cycles = false;
+#endif
+			auto cost = [cycles](counter const& c) { return cycles ? c.ticks : c.calls; };
+
+			counter all = {};
+			std::vector<size_t> order;
+			std::map<std::string, counter> families;
+			for (size_t i = 0; i < totals.size(); i++)
+			{
+				if (!totals[i].calls)
+					continue;
+				order.push_back(i);
+				all.calls += totals[i].calls;
+				all.ticks += totals[i].ticks;
+				auto& family = families[function_families[i]];
+				family.calls += totals[i].calls;
+				family.ticks += totals[i].ticks;
+			}
+			std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return cost(totals[a]) > cost(totals[b]); });
+
+			std::fprintf(f, "neon profile: %llu calls", (unsigned long long)all.calls);
+			if (cycles)
+				std::fprintf(f, ", %llu ticks", (unsigned long long)all.ticks);
+			std::fprintf(f, "\n%-24s %14s %16s %10s %7s\n", "function", "calls", "ticks", "ticks/call", "share");
+
+			auto row = [&](const char* name, counter const& c) {
+				double share = cost(all) ? 100.0 * double(cost(c)) / double(cost(all)) : 0;
+				if (cycles)
+					std::fprintf(f, "%-24s %14llu %16llu %10.1f %6.1f%%\n", name, (unsigned long long)c.calls, (unsigned long long)c.ticks, double(c.ticks) / double(c.calls), share);
+				else
+					std::fprintf(f, "%-24s %14llu %16s %10s %6.1f%%\n", name, (unsigned long long)c.calls, "-", "-", share);
+			};
+			for (size_t i : order)
+				row(function_names[i], totals[i]);
+
+			std::vector<std::pair<std::string, counter>> by_family(families.begin(), families.end());
+			std::sort(by_family.begin(), by_family.end(), [&](auto const& a, auto const& b) { return cost(a.second) > cost(b.second); });
+			std::fprintf(f, "\nby intrinsic\n");
+			for (auto& family : by_family)
+				row(family.first.c_str(), family.second);
+		}
+
+		inline void dump_estimate(FILE* f, const char* kernel, std::vector<counter> const& totals, size_t critical = 10)
+		{
+			uint64_t calls = 0;
+			for (auto& c : totals)
+				calls += c.calls;
+			if (!calls)
+				return;
+
+			std::fprintf(f, "\narm estimate, %s: %llu calls\n", kernel, (unsigned long long)calls);
+			std::fprintf(f, "%-24s %14s %8s %14s\n", "core", "throughput", "pipe", "latency");
+			for (size_t core = 0; core < NEON_PROFILE_CORES; core++)
+			{
+				double pipes[sizeof(pipe_names) / sizeof(pipe_names[0])] = {};
+				double latency = 0;
+				for (size_t i = 0; i < totals.size(); i++)
+				{
+					pipes[function_pipes[i]] += double(totals[i].calls) * function_throughput[core][i];
+					latency += double(totals[i].calls) * function_latency[core][i];
+				}
+				size_t busiest = size_t(std::max_element(std::begin(pipes), std::end(pipes)) - std::begin(pipes));
+				std::fprintf(f, "%-24s %14.0f %8s %14.0f\n", core_names[core], pipes[busiest], pipe_names[busiest], latency);
+			}
+
+			std::vector<size_t> order;
+			for (size_t i = 0; i < totals.size(); i++)
+				if (totals[i].calls)
+					order.push_back(i);
+			auto cycles = [&](size_t core, size_t i) { return double(totals[i].calls) * function_throughput[core][i]; };
+			std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return cycles(0, a) > cycles(0, b); });
+			order.resize(std::min(order.size(), critical));
+
+			std::fprintf(f, "%-24s %14s", "critical", "calls");
+			for (size_t core = 0; core < NEON_PROFILE_CORES; core++)
+				std::fprintf(f, " %14s", core_names[core]);
+			std::fprintf(f, "\n");
+			for (size_t i : order)
+			{
+				std::fprintf(f, "%-24s %14llu", function_names[i], (unsigned long long)totals[i].calls);
+				for (size_t core = 0; core < NEON_PROFILE_CORES; core++)
+					std::fprintf(f, " %14.1f", cycles(core, i));
+				std::fprintf(f, "\n");
+			}
+		}
+
+		// Totals of one kernel; kernel 0 holds the calls made outside any.
+		struct kernel_totals
+		{
+			const char* name;
+			std::atomic<uint64_t> calls[NEON_PROFILE_FUNCTIONS];
+			std::atomic<uint64_t> ticks[NEON_PROFILE_FUNCTIONS];
+
+			explicit kernel_totals(const char* name)
+				: name(name)
+			{
+				for (size_t i = 0; i < NEON_PROFILE_FUNCTIONS; i++)
+				{
+					calls[i].store(0, std::memory_order_relaxed);
+					ticks[i].store(0, std::memory_order_relaxed);
+				}
+			}
+		};
+
+		// Process totals, written out when the process exits.
+		struct totals
+		{
+			std::mutex lock;
+			std::atomic<kernel_totals*> kernels[NEON_PROFILE_KERNELS];
+			size_t count = 1;
+
+			totals()
+			{
+				kernels[0].store(new kernel_totals(""), std::memory_order_relaxed);
+				for (size_t k = 1; k < NEON_PROFILE_KERNELS; k++)
+					kernels[k].store(nullptr, std::memory_order_relaxed);
+			}
+
+			~totals()
+			{
+				std::vector<std::vector<counter>> snapshot(count, std::vector<counter>(NEON_PROFILE_FUNCTIONS));
+				std::vector<counter> run(NEON_PROFILE_FUNCTIONS);
+				for (size_t k = 0; k < count; k++)
+				{
+					auto* t = kernels[k].load(std::memory_order_acquire);
+					for (size_t i = 0; i < NEON_PROFILE_FUNCTIONS; i++)
+					{
+						snapshot[k][i] = { t->calls[i].load(std::memory_order_relaxed), t->ticks[i].load(std::memory_order_relaxed) };
+						run[i].calls += snapshot[k][i].calls;
+						run[i].ticks += snapshot[k][i].ticks;
+					}
+				}
+
+				const char* path = std::getenv("NEON_PROFILE_OUTPUT");
+				FILE* file = path ? std::fopen(path, "w") : nullptr;
+				FILE* f = file ? file : stderr;
+				dump_calls(f, run);
+				dump_estimate(f, "whole run", run);
+				for (size_t k = 1; k < count; k++)
+					dump_estimate(f, kernels[k].load()->name, snapshot[k]);
+				if (file)
+					std::fclose(file);
+
+				for (size_t k = 0; k < count; k++)
+					delete kernels[k].load();
+			}
+		};
+
+		inline totals& process()
+		{
+			static totals t;
+			return t;
+		}
+
+		// Id of the kernel called name, registered on first use. Past
+		// NEON_PROFILE_KERNELS kernels the calls go to kernel 0.
+		inline size_t kernel_id(const char* name)
+		{
+			auto& t = process();
+			std::lock_guard<std::mutex> hold(t.lock);
+			for (size_t k = 1; k < t.count; k++)
+				if (!std::strcmp(t.kernels[k].load(std::memory_order_relaxed)->name, name))
+					return k;
+			if (t.count == NEON_PROFILE_KERNELS)
+				return 0;
+			t.kernels[t.count].store(new kernel_totals(name), std::memory_order_release);
+			return t.count++;
+		}
+
+		struct thread_counters
+		{
+			std::vector<std::vector<counter>> kernels;
+			counter* current;
+
+			// Constructing the process totals first makes them outlive the
+			// thread_local counters of the main thread.
+			thread_counters()
+				: kernels(1, std::vector<counter>(NEON_PROFILE_FUNCTIONS))
+			{
+				process();
+				current = kernels[0].data();
+			}
+
+			~thread_counters()
+			{
+				auto& t = process();
+				for (size_t k = 0; k < kernels.size(); k++)
+				{
+					if (kernels[k].empty())
+						continue;
+					auto* totals = t.kernels[k].load(std::memory_order_acquire);
+					for (size_t i = 0; i < NEON_PROFILE_FUNCTIONS; i++)
+					{
+						if (!kernels[k][i].calls)
+							continue;
+						totals->calls[i].fetch_add(kernels[k][i].calls, std::memory_order_relaxed);
+						totals->ticks[i].fetch_add(kernels[k][i].ticks, std::memory_order_relaxed);
+					}
+				}
+			}
+
+			// Makes kernel the one counted into, returning the previous one.
+			counter* enter(size_t kernel)
+			{
+				if (kernel >= kernels.size())
+					kernels.resize(kernel + 1);
+				if (kernels[kernel].empty())
+					kernels[kernel].resize(NEON_PROFILE_FUNCTIONS);
+				counter* previous = current;
+				current = kernels[kernel].data();
+				return previous;
+			}
+		};
+
+		inline thread_counters& local()
+		{
+			static thread_local thread_counters t;
+			return t;
+		}
+
+		struct scope
+		{
+			counter& c;
+			uint64_t start;
+
+			// The counters are looked up first so a thread's first call
+			// doesn't time their construction.
+			explicit scope(size_t id)
+				: c(local().current[id]), start(ticks())
+			{
+			}
+
+			~scope()
+			{
+				c.calls++;
+				c.ticks += ticks() - start;
+			}
+		};
+
+		struct kernel
+		{
+			counter* previous;
+
+			explicit kernel(size_t id)
+				: previous(local().enter(id))
+			{
+			}
+
+			~kernel()
+			{
+				local().current = previous;
+			}
+
+			kernel(kernel const&) = delete;
+			kernel& operator=(kernel const&) = delete;
+		};
+
+	} // namespace profile
+
+} // namespace neon
+
+#else
+
+#define NEON_PROFILE_CALL(id)
+#define NEON_PROFILE_KERNEL(name)
+
+#endif
@@ -0,0 +1,301 @@
+#pragma once
+
+// Call trace of the generated api, recorded with NEON_TRACE and replayed on
+// the x86 backends by replay.cpp.
+//
+// Every api function makes its call through NEON_TRACE_CALL, which is the
+// bare call unless NEON_TRACE is defined. When it is, each call appends a
+// record to its thread's ring buffer, a file mapped with mmap: the function
+// id, the type of its lanes, then its operands and its result in 16-byte
+// slots, four to a record and continued in the next record when there are
+// more. Loads record the memory they read as the pointer's operand, stores
+// the memory they wrote as their result. The lane and immediate forms
+// (vdup_lane, vshl_n, vext) record their lane index or immediate as well.
+//
+// A thread's file is <NEON_TRACE_OUTPUT>.<pid>.<n>.trace (NEON_TRACE_OUTPUT
+// defaults to "neon") and keeps the last NEON_TRACE_RECORDS records, rounded
+// up to a power of two and to at least NEON_TRACE_CALL_RECORDS, the records
+// of the largest call; 2^18 by default at 80 bytes each. The head is written
+// after every call, so the trace of a crashed process is complete up to the
+// crash. A call costs a copy of its operands and result; if the file can't be
+// mapped, the thread isn't traced.
+
+#include <cstddef>
+#include <cstdint>
+
+#define NEON_TRACE_MAGIC 0x314352544e4f454eull // "NEONTRC1"
+
+namespace neon {
+
+	namespace trace {
+
+		struct header
+		{
+			uint64_t magic;
+			uint64_t api;      // NEON_API_HASH of the traced build
+			uint64_t capacity; // records in the ring
+			uint64_t head;     // records written, the oldest is at head - capacity
+			uint32_t record_size;
+			uint32_t pid;
+			uint32_t thread;
+			uint32_t reserved[5];
+		};
+
+		struct record
+		{
+			uint64_t seq;     // call number in the thread
+			uint16_t id;      // NEON_API_FUNCTIONS, then NEON_API_IMMEDIATE_RANGES
+			uint8_t lane;     // s8, s16, s32, s64, u8, u16, u32, u64, f16, f32, f64
+			uint8_t records;  // records of the call, 0 on its continuations
+			uint8_t memory;   // bytes a load read or a store wrote
+			uint8_t constant; // lane index or immediate of the lane and immediate forms
+			uint8_t reserved[2];
+			unsigned char slot[4][16];
+		};
+
+		static_assert(sizeof(header) == 64, "trace header layout");
+		static_assert(sizeof(record) == 80, "trace record layout");
+
+		inline size_t slots(size_t bytes)
+		{
+			return (bytes + 15) / 16;
+		}
+
+	} // namespace trace
+
+} // namespace neon
+
+#if defined(NEON_TRACE)
+
+#if defined(_WIN32)
+#error "NEON_TRACE needs mmap"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define NEON_TRACE_CALL(id, lane, memory, constant, args, ...) neon::trace::call(id, lane, memory, constant, [&]() -> decltype(auto) { return __VA_ARGS__; }, std::forward_as_tuple args)
+
+namespace neon {
+
+	namespace trace {
+
+		struct writer
+		{
+			header* h = nullptr;
+			record* records = nullptr;
+			size_t bytes = 0;
+			uint64_t capacity = uint64_t(1) << 18;
+			uint64_t head = 0;
+			uint64_t seq = 0;
+
+			writer()
+			{
+				static std::atomic<uint32_t> threads{ 0 };
+				const uint32_t thread = threads++;
+				const char* prefix = std::getenv("NEON_TRACE_OUTPUT");
+				const char* n = std::getenv("NEON_TRACE_RECORDS");
+				if (n)
+				{
+					// a power of two, so records are found with a mask, and
+					// room for the largest call, which would otherwise
+					// overwrite its own first record
+					const uint64_t wanted = std::max<uint64_t>(std::strtoull(n, nullptr, 0), NEON_TRACE_CALL_RECORDS);
+					for (capacity = 2; capacity < wanted; capacity *= 2)
+						;
+				}
+				bytes = sizeof(header) + capacity * sizeof(record);
+
+				char path[4096];
+				std::snprintf(path, sizeof(path), "%s.%d.%u.trace", prefix ? prefix : "neon", int(getpid()), thread);
+				int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+				void* map = MAP_FAILED;
+				if (fd >= 0 && ftruncate(fd, off_t(bytes)) == 0)
+					map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				if (fd >= 0)
+					close(fd);
+				if (map == MAP_FAILED)
+				{
+					std::fprintf(stderr, "neon: can't map trace %s, thread not traced\n", path);
+					return;
+				}
+
+				h = static_cast<header*>(map);
+				h->magic = NEON_TRACE_MAGIC;
+				h->api = NEON_API_HASH;
+				h->capacity = capacity;
+				h->head = 0;
+				h->record_size = sizeof(record);
+				h->pid = uint32_t(getpid());
+				h->thread = thread;
+				records = reinterpret_cast<record*>(h + 1);
+			}
+
+			~writer()
+			{
+				if (h)
+					munmap(h, bytes);
+			}
+
+			writer(writer const&) = delete;
+			writer& operator=(writer const&) = delete;
+		};
+
+		inline writer& local()
+		{
+			static thread_local writer w;
+			return w;
+		}
+
+		// Writes a call's slots into the records reserved for it.
+		struct cursor
+		{
+			writer& w;
+			size_t slot = 0;
+
+			void put(void const* p, size_t bytes)
+			{
+				auto* b = static_cast<unsigned char const*>(p);
+				for (; bytes; slot++)
+				{
+					size_t n = std::min<size_t>(bytes, 16);
+					unsigned char* s = w.records[(w.head + slot / 4) & (w.capacity - 1)].slot[slot % 4];
+					std::memcpy(s, b, n);
+					std::memset(s + n, 0, 16 - n);
+					b += n;
+					bytes -= n;
+				}
+			}
+		};
+
+		template <typename T>
+		size_t operand_slots(T const&, size_t)
+		{
+			return slots(sizeof(T));
+		}
+
+		template <typename T>
+		size_t operand_slots(T* const&, size_t memory)
+		{
+			return slots(memory);
+		}
+
+		template <typename T>
+		void put_operand(cursor& c, T const& v, size_t)
+		{
+			c.put(&v, sizeof(T));
+		}
+
+		template <typename T>
+		void put_operand(cursor& c, T* const& p, size_t memory)
+		{
+			if (std::is_const<T>::value)
+				c.put(p, memory);
+		}
+
+		template <typename T>
+		void put_stored(cursor&, T const&, size_t)
+		{
+		}
+
+		template <typename T>
+		void put_stored(cursor& c, T* const& p, size_t memory)
+		{
+			if (!std::is_const<T>::value)
+				c.put(p, memory);
+		}
+
+		template <typename R>
+		size_t result_slots()
+		{
+			return slots(sizeof(R));
+		}
+
+		template <>
+		inline size_t result_slots<void>()
+		{
+			return 0;
+		}
+
+		template <typename Tuple, typename F, size_t... I>
+		void each(Tuple const& t, F f, std::index_sequence<I...>)
+		{
+			int unused[] = { (f(std::get<I>(t)), 0)..., 0 };
+			(void)unused;
+		}
+
+		// Reserves the records of a call and writes its operands.
+		template <typename R, typename... A>
+		cursor begin(writer& w, uint16_t id, uint8_t lane, uint8_t memory, uint8_t constant, std::tuple<A&...> const& args)
+		{
+			size_t n = result_slots<R>();
+			each(args, [&](auto const& a) { n += operand_slots(a, memory); }, std::index_sequence_for<A...>());
+			const uint8_t count = uint8_t(std::max<size_t>((n + 3) / 4, 1));
+			for (uint8_t i = 0; i < count; i++)
+			{
+				record& r = w.records[(w.head + i) & (w.capacity - 1)];
+				r.seq = w.seq;
+				r.id = id;
+				r.lane = lane;
+				r.records = i ? 0 : count;
+				r.memory = memory;
+				r.constant = constant;
+			}
+			cursor c{ w };
+			each(args, [&](auto const& a) { put_operand(c, a, memory); }, std::index_sequence_for<A...>());
+			return c;
+		}
+
+		inline void end(writer& w)
+		{
+			w.head += w.records[w.head & (w.capacity - 1)].records;
+			w.seq++;
+			w.h->head = w.head;
+		}
+
+		template <typename F, typename... A>
+		auto call(uint16_t id, uint8_t lane, uint8_t memory, uint8_t constant, F f, std::tuple<A&...> args)
+			-> typename std::enable_if<!std::is_void<decltype(f())>::value, decltype(f())>::type
+		{
+			writer& w = local();
+			if (!w.h)
+				return f();
+			cursor c = begin<decltype(f())>(w, id, lane, memory, constant, args);
+			auto r = f();
+			c.put(&r, sizeof(r));
+			end(w);
+			return r;
+		}
+
+		template <typename F, typename... A>
+		auto call(uint16_t id, uint8_t lane, uint8_t memory, uint8_t constant, F f, std::tuple<A&...> args)
+			-> typename std::enable_if<std::is_void<decltype(f())>::value>::type
+		{
+			writer& w = local();
+			if (!w.h)
+				return f();
+			cursor c = begin<void>(w, id, lane, memory, constant, args);
+			f();
+			each(args, [&](auto const& a) { put_stored(c, a, memory); }, std::index_sequence_for<A...>());
+			end(w);
+		}
+
+	} // namespace trace
+
+} // namespace neon
+
+#else
+
+#define NEON_TRACE_CALL(id, lane, memory, constant, args, ...) __VA_ARGS__
+
+#endif
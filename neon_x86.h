@@ -0,0 +1,1850 @@
+// x86 backend for the neon:: templates.
+//
+// Every op gets a kernel in x86::lanes<T> working on one 128-bit register, and
+// a pair of non-template neon64/neon128 overloads that load, run the kernel and
+// store. Non-template overloads win over the scalar templates in neon.h, which
+// stay the reference: neon::vadd<T>(a0, a1) always picks the scalar loop.
+//
+// neon64 values are loaded into the low half of a register with the upper half
+// zeroed, so the same kernel serves both widths.
+//
+// The kernels are compiled for NEON_X86_LEVEL, which is NEON_BACKEND for the
+// include from neon.h. With NEON_RUNTIME_DISPATCH that include compiles none,
+// and the generated api includes this file again per backend with
+// NEON_X86_NAMESPACE and NEON_X86_LEVEL set under the matching target pragma
+// (see neon_dispatch.h).
+
+#if !defined(NEON_X86_NAMESPACE)
+#if !defined(NEON_X86_H)
+#define NEON_X86_H
+
+#define NEON_BACKEND_SCALAR 0
+#define NEON_BACKEND_SSE42 1
+#define NEON_BACKEND_AVX2 2
+#define NEON_BACKEND_AVX512 3
+
+#ifndef NEON_BACKEND
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+#define NEON_BACKEND NEON_BACKEND_AVX512
+#elif defined(__AVX2__)
+#define NEON_BACKEND NEON_BACKEND_AVX2
+#elif defined(__SSE4_2__)
+#define NEON_BACKEND NEON_BACKEND_SSE42
+#else
+#define NEON_BACKEND NEON_BACKEND_SCALAR
+#endif
+#endif
+
+#if defined(NEON_RUNTIME_DISPATCH)
+#define NEON_X86_LEVEL NEON_BACKEND_SCALAR
+#else
+#define NEON_X86_LEVEL NEON_BACKEND
+#endif
+#else
+#define NEON_X86_LEVEL NEON_BACKEND_SCALAR
+#endif
+#endif
+
+#if NEON_X86_LEVEL >= NEON_BACKEND_SSE42
+
+// Target pragmas don't define the feature macros, so a dispatched copy takes
+// FMA and F16C from its level; the avx2 target strings in neon_dispatch.h
+// enable both.
+#undef NEON_X86_FMA
+#undef NEON_X86_F16C
+#if defined(__FMA__) || (defined(NEON_X86_NAMESPACE) && NEON_X86_LEVEL >= NEON_BACKEND_AVX2)
+#define NEON_X86_FMA 1
+#endif
+#if defined(__F16C__) || (defined(NEON_X86_NAMESPACE) && NEON_X86_LEVEL >= NEON_BACKEND_AVX2)
+#define NEON_X86_F16C 1
+#endif
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace neon {
+#if defined(NEON_X86_NAMESPACE)
+namespace NEON_X86_NAMESPACE {
+#endif
+
+	namespace x86 {
+
+		template <typename V>
+		inline __m128i load(V const& a)
+		{
+			static_assert(sizeof(V) == 8 || sizeof(V) == 16, "not a neon register");
+			__m128i r = _mm_setzero_si128();
+			std::memcpy(&r, &a, sizeof(V));
+			return r;
+		}
+
+		template <typename V>
+		inline V store(__m128i r)
+		{
+			static_assert(sizeof(V) == 8 || sizeof(V) == 16, "not a neon register");
+			V v;
+			std::memcpy(&v, &r, sizeof(V));
+			return v;
+		}
+
+		// Unsigned 64-bit a > b; SSE4.2 only has the signed compare.
+		inline __m128i cmpgt_epu64(__m128i a, __m128i b)
+		{
+			const __m128i bias = _mm_set1_epi64x(INT64_MIN);
+			return _mm_cmpgt_epi64(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+		}
+
+		// Two's complement negate of the lanes selected by an all-ones mask.
+		inline __m128i cneg_epi64(__m128i a, __m128i m)
+		{
+			return _mm_sub_epi64(_mm_xor_si128(a, m), m);
+		}
+
+		inline __m128i not_si128(__m128i a)
+		{
+			return _mm_xor_si128(a, _mm_set1_epi32(-1));
+		}
+
+		// FPSR.QC tracking for the saturating kernels: one movemask and a
+		// not-taken branch per op.
+		inline void qc_if(__m128i saturated)
+		{
+			if (_mm_movemask_epi8(saturated))
+				fpsr_qc() = true;
+		}
+
+		inline void qc_unless(__m128i exact)
+		{
+			if (_mm_movemask_epi8(exact) != 0xffff)
+				fpsr_qc() = true;
+		}
+
+		// Lanes of r equal to INT_MIN after a doubling multiply or negate only
+		// got there by overflowing; flip them to INT_MAX.
+		inline __m128i fix_min_epi16(__m128i r)
+		{
+			__m128i m = _mm_cmpeq_epi16(r, _mm_set1_epi16(INT16_MIN));
+			qc_if(m);
+			return _mm_xor_si128(r, m);
+		}
+
+		inline __m128i fix_min_epi32(__m128i r)
+		{
+			__m128i m = _mm_cmpeq_epi32(r, _mm_set1_epi32(INT32_MIN));
+			qc_if(m);
+			return _mm_xor_si128(r, m);
+		}
+
+		// Signed add/sub overflow for 32/64-bit lanes, which x86 can't saturate:
+		// the sign bit of `overflow` picks INT_MIN or INT_MAX by the sign of a.
+		inline __m128i sat_epi32(__m128i r, __m128i a, __m128i overflow)
+		{
+			if (_mm_movemask_ps(_mm_castsi128_ps(overflow)))
+				fpsr_qc() = true;
+			__m128i sat = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(INT32_MAX));
+			return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(r), _mm_castsi128_ps(sat), _mm_castsi128_ps(overflow)));
+		}
+
+		inline __m128i sat_epi64(__m128i r, __m128i a, __m128i overflow)
+		{
+			if (_mm_movemask_pd(_mm_castsi128_pd(overflow)))
+				fpsr_qc() = true;
+			__m128i sat = _mm_xor_si128(_mm_cmpgt_epi64(_mm_setzero_si128(), a), _mm_set1_epi64x(INT64_MAX));
+			return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(r), _mm_castsi128_pd(sat), _mm_castsi128_pd(overflow)));
+		}
+
+		// High half of 2 * a * b [+ 2^31] per 32-bit lane, from the even and odd
+		// 64-bit pmuldq products. INT32_MIN * INT32_MIN wraps to INT32_MIN.
+		template <bool Round>
+		inline __m128i doubling_mulh_epi32(__m128i a, __m128i b)
+		{
+			const __m128i half = _mm_set1_epi64x(Round ? 1 << 30 : 0);
+			__m128i even = _mm_slli_epi64(_mm_add_epi64(_mm_mul_epi32(a, b), half), 1);
+			__m128i odd = _mm_slli_epi64(_mm_add_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), half), 1);
+			return _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xcc);
+		}
+
+		// There is no byte multiply: multiply the even and odd bytes in 16-bit
+		// lanes and merge the low bytes of the products.
+		inline __m128i mullo_epi8(__m128i a, __m128i b)
+		{
+			__m128i even = _mm_mullo_epi16(a, b);
+			__m128i odd = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+			return _mm_blendv_epi8(_mm_slli_epi16(odd, 8), even, _mm_set1_epi16(0x00ff));
+		}
+
+		// There are no byte shifts either: shift 16-bit lanes and mask off the
+		// bits that crossed into the neighbouring byte. The arithmetic shift
+		// sign-extends the logical one from bit 7 - N; N stays below 8.
+		template <int N>
+		inline __m128i slli_epi8(__m128i a)
+		{
+			return _mm_and_si128(_mm_slli_epi16(a, N), _mm_set1_epi8(char(0xff << N)));
+		}
+
+		template <int N>
+		inline __m128i srli_epi8(__m128i a)
+		{
+			return _mm_and_si128(_mm_srli_epi16(a, N), _mm_set1_epi8(char(0xff >> N)));
+		}
+
+		template <int N>
+		inline __m128i srai_epi8(__m128i a)
+		{
+			const __m128i m = _mm_set1_epi8(char(0x80 >> N));
+			return _mm_sub_epi8(_mm_xor_si128(srli_epi8<N>(a), m), m);
+		}
+
+		// 64-bit arithmetic shift right, AVX-512 only: a logical shift of the
+		// value with its sign folded away, then put back.
+		template <int N>
+		inline __m128i srai_epi64(__m128i a)
+		{
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+			return _mm_srai_epi64(a, N);
+#else
+			__m128i s = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
+			return _mm_xor_si128(_mm_srli_epi64(_mm_xor_si128(a, s), N), s);
+#endif
+		}
+
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+		// Byte and, before AVX-512, 16-bit variable shifts: widen the lanes to
+		// 32 bits in a ymm register, shift them with sllv, srav or srlv and pack
+		// the low bits back. Counts are sign-extended, so negative ones stay out
+		// of range the way they are for the native shifts.
+		enum class shiftv
+		{
+			left,
+			arithmetic,
+			logical
+		};
+
+		template <shiftv Op>
+		inline __m256i shiftv_epi32(__m256i a, __m256i n)
+		{
+			return Op == shiftv::left ? _mm256_sllv_epi32(a, n) : Op == shiftv::arithmetic ? _mm256_srav_epi32(a, n) : _mm256_srlv_epi32(a, n);
+		}
+
+		template <shiftv Op>
+		inline __m256i shiftv_epi8_epi32(__m128i a, __m128i n)
+		{
+			__m256i w = Op == shiftv::logical ? _mm256_cvtepu8_epi32(a) : _mm256_cvtepi8_epi32(a);
+			return _mm256_and_si256(shiftv_epi32<Op>(w, _mm256_cvtepi8_epi32(n)), _mm256_set1_epi32(0xff));
+		}
+
+		template <shiftv Op>
+		inline __m128i shiftv_epi8(__m128i a, __m128i n)
+		{
+			__m256i lo = shiftv_epi8_epi32<Op>(a, n);
+			__m256i hi = shiftv_epi8_epi32<Op>(_mm_unpackhi_epi64(a, a), _mm_unpackhi_epi64(n, n));
+			__m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xd8);
+			return _mm_packus_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+		}
+
+		template <shiftv Op>
+		inline __m128i shiftv_epi16(__m128i a, __m128i n)
+		{
+			__m256i w = Op == shiftv::logical ? _mm256_cvtepu16_epi32(a) : _mm256_cvtepi16_epi32(a);
+			__m256i r = _mm256_blend_epi16(shiftv_epi32<Op>(w, _mm256_cvtepi16_epi32(n)), _mm256_setzero_si256(), 0xaa);
+			return _mm_packus_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+		}
+#endif
+
+		// Hides a product from the compiler so it can't contract it with a
+		// following add into an fma; ARM rounds every vmul/vmla product.
+		template <typename F>
+		inline F unfused(F a)
+		{
+#if defined(__GNUC__)
+			__asm__("" : "+x"(a));
+#endif
+			return a;
+		}
+
+		// Upper 64 bits moved down, for the _high forms of the widening ops.
+		inline __m128i high(__m128i a)
+		{
+			return _mm_unpackhi_epi64(a, a);
+		}
+
+		// Lane broadcast by element size, one shuffle with an immediate or a
+		// constant pshufb mask.
+		template <size_t Size>
+		struct broadcast;
+
+		template <>
+		struct broadcast<1>
+		{
+			template <int Lane> static __m128i lane(__m128i a) { return _mm_shuffle_epi8(a, _mm_set1_epi8(Lane)); }
+		};
+
+		template <>
+		struct broadcast<2>
+		{
+			template <int Lane> static __m128i lane(__m128i a) { return _mm_shuffle_epi8(a, _mm_set1_epi16(short(0x0202 * Lane + 0x0100))); }
+		};
+
+		template <>
+		struct broadcast<4>
+		{
+			template <int Lane> static __m128i lane(__m128i a) { return _mm_shuffle_epi32(a, 0x55 * Lane); }
+		};
+
+		template <>
+		struct broadcast<8>
+		{
+			template <int Lane> static __m128i lane(__m128i a) { return _mm_shuffle_epi32(a, Lane ? 0xee : 0x44); }
+		};
+
+		// Reductions take d registers with the low half copied into the high
+		// half, so min/max can look at all 16 bytes while sums only add the N
+		// lanes they were given.
+		template <typename V>
+		inline __m128i load_dup(V const& a)
+		{
+			__m128i r = load(a);
+			return sizeof(V) == 8 ? _mm_unpacklo_epi64(r, r) : r;
+		}
+
+		template <typename R>
+		inline R first(__m128i a)
+		{
+			R r;
+			std::memcpy(&r, &a, sizeof(R));
+			return r;
+		}
+
+		// Log-depth fold of Size-byte lanes: the upper half of the first Bytes
+		// bytes is combined into the lower half until lane 0 holds the result.
+		template <size_t Size, size_t Bytes, __m128i (*Op)(__m128i, __m128i)>
+		inline __m128i fold(__m128i a)
+		{
+			if (Size <= 8 && Bytes > 8) a = Op(a, _mm_unpackhi_epi64(a, a));
+			if (Size <= 4 && Bytes > 4) a = Op(a, _mm_srli_epi64(a, 32));
+			if (Size <= 2 && Bytes > 2) a = Op(a, _mm_srli_epi32(a, 16));
+			if (Size <= 1 && Bytes > 1) a = Op(a, _mm_srli_epi16(a, 8));
+			return a;
+		}
+
+		// Sum of the first N 32-bit lanes.
+		template <size_t N>
+		inline __m128i hsum_epi32(__m128i a)
+		{
+			if (N > 2) a = _mm_add_epi32(a, _mm_unpackhi_epi64(a, a));
+			if (N > 1) a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 1));
+			return a;
+		}
+
+		// Sum of the first N bytes: psadbw against zero gives one sum per qword.
+		template <size_t N>
+		inline __m128i sum_epu8(__m128i a)
+		{
+			__m128i s = _mm_sad_epu8(a, _mm_setzero_si128());
+			return N > 8 ? _mm_add_epi64(s, _mm_unpackhi_epi64(s, s)) : s;
+		}
+
+		// Unsigned byte minimum of all 16 bytes in the low word: the byte pairs
+		// are folded into zero-extended words for phminposuw.
+		inline __m128i minpos_epu8(__m128i a)
+		{
+			return _mm_minpos_epu16(_mm_min_epu8(a, _mm_srli_epi16(a, 8)));
+		}
+
+		// Adjacent byte sums of a into the low half and of b into the high half.
+		inline __m128i padd_epi8(__m128i a, __m128i b)
+		{
+			const __m128i low = _mm_set1_epi16(0x00ff);
+			__m128i sa = _mm_and_si128(_mm_add_epi8(a, _mm_srli_epi16(a, 8)), low);
+			__m128i sb = _mm_and_si128(_mm_add_epi8(b, _mm_srli_epi16(b, 8)), low);
+			return _mm_packus_epi16(sa, sb);
+		}
+
+		// Compares every lanes<T> derives from the three it defines itself:
+		// ceq, cgt and cge. Swapped operands give clt/cle, which also holds for
+		// floats since a < b is b > a even when one of them is a NaN.
+		template <typename L, typename T>
+		struct compare_ops
+		{
+			static __m128i clt(__m128i a, __m128i b) { return L::cgt(b, a); }
+			static __m128i cle(__m128i a, __m128i b) { return L::cge(b, a); }
+
+			static __m128i ceqz(__m128i a) { return L::ceq(a, _mm_setzero_si128()); }
+			static __m128i cgez(__m128i a) { return std::is_unsigned<T>::value ? _mm_set1_epi32(-1) : L::cge(a, _mm_setzero_si128()); }
+			static __m128i cgtz(__m128i a) { return std::is_unsigned<T>::value ? not_si128(ceqz(a)) : L::cgt(a, _mm_setzero_si128()); }
+			static __m128i clez(__m128i a) { return std::is_unsigned<T>::value ? ceqz(a) : L::cge(_mm_setzero_si128(), a); }
+			static __m128i cltz(__m128i a) { return std::is_unsigned<T>::value ? _mm_setzero_si128() : L::cgt(_mm_setzero_si128(), a); }
+		};
+
+		// Bitwise ops don't depend on the lane type: every lanes<T> inherits the
+		// same 128-bit kernels, one and/andnot/or/xor or a single vpternlog.
+		struct bitwise_ops
+		{
+			static __m128i band(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+			static __m128i borr(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+			static __m128i beor(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+			static __m128i bic(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+			static __m128i mvn(__m128i a) { return _mm_ternarylogic_epi32(a, a, a, 0x0f); }
+			static __m128i orn(__m128i a, __m128i b) { return _mm_ternarylogic_epi32(a, b, b, 0xf3); }
+			static __m128i bsl(__m128i m, __m128i a, __m128i b) { return _mm_ternarylogic_epi32(m, a, b, 0xca); }
+			static __m128i bcax(__m128i a, __m128i b, __m128i c) { return _mm_ternarylogic_epi32(a, b, c, 0xb4); }
+			static __m128i eor3(__m128i a, __m128i b, __m128i c) { return _mm_ternarylogic_epi32(a, b, c, 0x96); }
+#else
+			static __m128i mvn(__m128i a) { return not_si128(a); }
+			static __m128i orn(__m128i a, __m128i b) { return _mm_or_si128(a, not_si128(b)); }
+			static __m128i bsl(__m128i m, __m128i a, __m128i b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+			static __m128i bcax(__m128i a, __m128i b, __m128i c) { return _mm_xor_si128(a, _mm_andnot_si128(c, b)); }
+			static __m128i eor3(__m128i a, __m128i b, __m128i c) { return _mm_xor_si128(_mm_xor_si128(a, b), c); }
+#endif
+		};
+
+		template <typename T>
+		struct lanes;
+
+		// Shifts every integer lanes<T> derives from its immediate shl, shr
+		// (arithmetic for signed lanes) and srl (logical) kernels. Rounding adds
+		// the last bit shifted out, which is ARM's 2^(N-1) bias without the
+		// overflow; narrowing shifts take narrow (truncating) and qnarrow
+		// (saturating) from the wide lanes, as does vaddhn.
+		//
+		// The register-count forms need x86's variable shifts, shlv and shrv,
+		// which the 32/64-bit lanes have from AVX2 and the 16-bit ones from
+		// AVX-512; below that the 8/16-bit lanes shift widened to 32 bits.
+		// Counts are signed, so lanes<signed>::count and cltz pick them apart;
+		// variable shifts already give ARM's result for counts past the lane
+		// width, which covers both directions.
+		template <typename L, typename T>
+		struct shift_ops
+		{
+			using S = lanes<typename std::make_signed<T>::type>;
+
+			static __m128i one() { return L::template srl<8 * sizeof(T) - 1>(_mm_set1_epi32(-1)); }
+
+			template <int N> static __m128i rshr(__m128i a) { return L::add(L::template shr<N>(a), _mm_and_si128(L::template srl<N - 1>(a), one())); }
+			template <int N> static __m128i sra(__m128i a, __m128i b) { return L::add(a, L::template shr<N>(b)); }
+			template <int N> static __m128i rsra(__m128i a, __m128i b) { return L::add(a, rshr<N>(b)); }
+			template <int N> static __m128i sli(__m128i a, __m128i b) { return L::bsl(L::template shl<N>(_mm_set1_epi32(-1)), L::template shl<N>(b), a); }
+			template <int N> static __m128i sri(__m128i a, __m128i b) { return L::bsl(L::template srl<N>(_mm_set1_epi32(-1)), L::template srl<N>(b), a); }
+
+			template <int N> static __m128i shrn(__m128i a) { return L::narrow(L::template srl<N>(a)); }
+			template <int N> static __m128i rshrn(__m128i a) { return L::narrow(rshr<N>(a)); }
+			template <int N> static __m128i qshrn(__m128i a) { return L::qnarrow(L::template shr<N>(a)); }
+			template <int N> static __m128i qrshrn(__m128i a) { return L::qnarrow(rshr<N>(a)); }
+			static __m128i addhn(__m128i a, __m128i b) { return shrn<4 * sizeof(T)>(L::add(a, b)); }
+
+			static __m128i shl_by(__m128i a, __m128i c)
+			{
+				__m128i n = S::count(c);
+				return L::bsl(S::cltz(n), L::shrv(a, L::sub(_mm_setzero_si128(), n)), L::shlv(a, n));
+			}
+
+			static __m128i rshl_by(__m128i a, __m128i c)
+			{
+				__m128i n = S::count(c);
+				__m128i m = L::sub(_mm_setzero_si128(), n);
+				__m128i right = L::add(L::shrv(a, m), _mm_and_si128(L::shrv(a, L::sub(m, one())), one()));
+				return L::bsl(S::cltz(n), right, L::shlv(a, n));
+			}
+
+			// Left shifts saturate when shifting back doesn't give a0 again.
+			static __m128i qshl_by(__m128i a, __m128i c)
+			{
+				__m128i n = S::count(c);
+				__m128i negative = S::cltz(n);
+				__m128i r = L::shlv(a, n);
+				__m128i lost = not_si128(_mm_or_si128(negative, L::ceq(L::shrv(r, n), a)));
+				qc_if(lost);
+				__m128i sat = std::is_signed<T>::value ? _mm_xor_si128(S::cltz(a), L::template srl<1>(_mm_set1_epi32(-1))) : _mm_set1_epi32(-1);
+				return L::bsl(negative, L::shrv(a, L::sub(_mm_setzero_si128(), n)), L::bsl(lost, sat, r));
+			}
+		};
+
+		// Halving adds and subtracts. pavgb/pavgw round (a + b + 1) >> 1 of
+		// unsigned lanes, and flipping the operands and the result biases that
+		// into the other forms: the sign bit moves signed lanes to unsigned
+		// range, and ~avg(~a, ~b) rounds down instead. 32-bit lanes use the
+		// overflow-free (a & b) + ((a ^ b) >> 1) and its relatives.
+		template <typename L, typename T>
+		struct halving_ops
+		{
+			static constexpr T sign = std::numeric_limits<T>::min();
+			static constexpr T top = T(std::numeric_limits<typename std::make_signed<T>::type>::min());
+
+			static __m128i avg(__m128i a, __m128i b, T x, T y, T z)
+			{
+				if (sizeof(T) == 1)
+					return _mm_xor_si128(_mm_avg_epu8(_mm_xor_si128(a, _mm_set1_epi8(char(x))), _mm_xor_si128(b, _mm_set1_epi8(char(y)))), _mm_set1_epi8(char(z)));
+				return _mm_xor_si128(_mm_avg_epu16(_mm_xor_si128(a, _mm_set1_epi16(short(x))), _mm_xor_si128(b, _mm_set1_epi16(short(y)))), _mm_set1_epi16(short(z)));
+			}
+
+			static __m128i hadd(__m128i a, __m128i b) { return sizeof(T) > 2 ? L::add(_mm_and_si128(a, b), L::template shr<1>(_mm_xor_si128(a, b))) : avg(a, b, T(~sign), T(~sign), T(~sign)); }
+			static __m128i rhadd(__m128i a, __m128i b) { return sizeof(T) > 2 ? L::sub(_mm_or_si128(a, b), L::template shr<1>(_mm_xor_si128(a, b))) : avg(a, b, sign, sign, sign); }
+			static __m128i hsub(__m128i a, __m128i b) { return sizeof(T) > 2 ? L::sub(L::template shr<1>(_mm_xor_si128(a, b)), _mm_andnot_si128(a, b)) : avg(a, b, sign, T(~sign), top); }
+		};
+
+		template <>
+		struct lanes<int8_t> : compare_ops<lanes<int8_t>, int8_t>, bitwise_ops, shift_ops<lanes<int8_t>, int8_t>, halving_ops<lanes<int8_t>, int8_t>
+		{
+			static __m128i add(__m128i a, __m128i b) { return _mm_add_epi8(a, b); }
+			static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi8(a, b); }
+			static __m128i abd(__m128i a, __m128i b) { return _mm_sub_epi8(_mm_max_epi8(a, b), _mm_min_epi8(a, b)); }
+			static __m128i abs(__m128i a) { return _mm_abs_epi8(a); }
+
+			static __m128i mul(__m128i a, __m128i b) { return mullo_epi8(a, b); }
+			static __m128i mull(__m128i a, __m128i b) { return _mm_mullo_epi16(_mm_cvtepi8_epi16(a), _mm_cvtepi8_epi16(b)); }
+			static __m128i widen(__m128i a) { return _mm_cvtepi8_epi16(a); }
+			static __m128i abdl(__m128i a, __m128i b) { return _mm_cvtepu8_epi16(abd(a, b)); }
+
+			static __m128i ceq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+			static __m128i cgt(__m128i a, __m128i b) { return _mm_cmpgt_epi8(a, b); }
+			static __m128i cge(__m128i a, __m128i b) { return not_si128(_mm_cmpgt_epi8(b, a)); }
+
+			static __m128i qadd(__m128i a, __m128i b) { __m128i r = _mm_adds_epi8(a, b); qc_unless(_mm_cmpeq_epi8(r, _mm_add_epi8(a, b))); return r; }
+			static __m128i qsub(__m128i a, __m128i b) { __m128i r = _mm_subs_epi8(a, b); qc_unless(_mm_cmpeq_epi8(r, _mm_sub_epi8(a, b))); return r; }
+			static __m128i qabs(__m128i a) { qc_if(_mm_cmpeq_epi8(a, _mm_set1_epi8(INT8_MIN))); return _mm_min_epu8(_mm_abs_epi8(a), _mm_set1_epi8(-(INT8_MIN + 1))); }
+			static __m128i qneg(__m128i a) { qc_if(_mm_cmpeq_epi8(a, _mm_set1_epi8(INT8_MIN))); return _mm_subs_epi8(_mm_setzero_si128(), a); }
+
+			template <size_t N> static __m128i addv(__m128i a) { return sum_epu8<N>(a); }
+			template <size_t N> static __m128i addlv(__m128i a) { return _mm_sub_epi64(sum_epu8<N>(_mm_xor_si128(a, _mm_set1_epi8(INT8_MIN))), _mm_set1_epi64x(128 * N)); }
+			template <size_t N> static __m128i maxv(__m128i a) { return _mm_xor_si128(minpos_epu8(_mm_xor_si128(a, _mm_set1_epi8(INT8_MAX))), _mm_set1_epi8(INT8_MAX)); }
+			template <size_t N> static __m128i minv(__m128i a) { return _mm_xor_si128(minpos_epu8(_mm_xor_si128(a, _mm_set1_epi8(INT8_MIN))), _mm_set1_epi8(INT8_MIN)); }
+			static __m128i padd(__m128i a, __m128i b) { return padd_epi8(a, b); }
+			static __m128i paddl(__m128i a) { return _mm_maddubs_epi16(_mm_set1_epi8(1), a); }
+
+			template <int N> static __m128i shl(__m128i a) { return slli_epi8<N>(a); }
+			template <int N> static __m128i shr(__m128i a) { return srai_epi8<(N < 8 ? N : 7)>(a); }
+			template <int N> static __m128i srl(__m128i a) { return srli_epi8<N>(a); }
+			static __m128i count(__m128i c) { return c; }
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+			static __m128i shlv(__m128i a, __m128i n) { return shiftv_epi8<shiftv::left>(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return shiftv_epi8<shiftv::arithmetic>(a, n); }
+#endif
+		};
+
+		template <>
+		struct lanes<uint8_t> : compare_ops<lanes<uint8_t>, uint8_t>, bitwise_ops, shift_ops<lanes<uint8_t>, uint8_t>, halving_ops<lanes<uint8_t>, uint8_t>
+		{
+			static __m128i add(__m128i a, __m128i b) { return _mm_add_epi8(a, b); }
+			static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi8(a, b); }
+			static __m128i abd(__m128i a, __m128i b) { return _mm_sub_epi8(_mm_max_epu8(a, b), _mm_min_epu8(a, b)); }
+
+			static __m128i mul(__m128i a, __m128i b) { return mullo_epi8(a, b); }
+			static __m128i mull(__m128i a, __m128i b) { return _mm_mullo_epi16(_mm_cvtepu8_epi16(a), _mm_cvtepu8_epi16(b)); }
+			static __m128i widen(__m128i a) { return _mm_cvtepu8_epi16(a); }
+			static __m128i abdl(__m128i a, __m128i b) { return _mm_cvtepu8_epi16(abd(a, b)); }
+
+			static __m128i ceq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+			static __m128i cgt(__m128i a, __m128i b) { return _mm_cmpgt_epi8(_mm_xor_si128(a, _mm_set1_epi8(INT8_MIN)), _mm_xor_si128(b, _mm_set1_epi8(INT8_MIN))); }
+			static __m128i cge(__m128i a, __m128i b) { return _mm_cmpeq_epi8(_mm_max_epu8(a, b), a); }
+
+			static __m128i qadd(__m128i a, __m128i b) { __m128i r = _mm_adds_epu8(a, b); qc_unless(_mm_cmpeq_epi8(r, _mm_add_epi8(a, b))); return r; }
+			static __m128i qsub(__m128i a, __m128i b) { __m128i r = _mm_subs_epu8(a, b); qc_unless(_mm_cmpeq_epi8(r, _mm_sub_epi8(a, b))); return r; }
+
+			template <size_t N> static __m128i addv(__m128i a) { return sum_epu8<N>(a); }
+			template <size_t N> static __m128i addlv(__m128i a) { return sum_epu8<N>(a); }
+			template <size_t N> static __m128i maxv(__m128i a) { return not_si128(minpos_epu8(not_si128(a))); }
+			template <size_t N> static __m128i minv(__m128i a) { return minpos_epu8(a); }
+			static __m128i padd(__m128i a, __m128i b) { return padd_epi8(a, b); }
+			static __m128i paddl(__m128i a) { return _mm_maddubs_epi16(a, _mm_set1_epi8(1)); }
+
+			template <int N> static __m128i shl(__m128i a) { return slli_epi8<N>(a); }
+			template <int N> static __m128i shr(__m128i a) { return srli_epi8<N>(a); }
+			template <int N> static __m128i srl(__m128i a) { return srli_epi8<N>(a); }
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+			static __m128i shlv(__m128i a, __m128i n) { return shiftv_epi8<shiftv::left>(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return shiftv_epi8<shiftv::logical>(a, n); }
+#endif
+		};
+
+		template <>
+		struct lanes<int16_t> : compare_ops<lanes<int16_t>, int16_t>, bitwise_ops, shift_ops<lanes<int16_t>, int16_t>, halving_ops<lanes<int16_t>, int16_t>
+		{
+			static __m128i add(__m128i a, __m128i b) { return _mm_add_epi16(a, b); }
+			static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi16(a, b); }
+			static __m128i abd(__m128i a, __m128i b) { return _mm_sub_epi16(_mm_max_epi16(a, b), _mm_min_epi16(a, b)); }
+			static __m128i abs(__m128i a) { return _mm_abs_epi16(a); }
+
+			static __m128i mul(__m128i a, __m128i b) { return _mm_mullo_epi16(a, b); }
+			static __m128i mull(__m128i a, __m128i b) { return _mm_madd_epi16(_mm_unpacklo_epi16(a, _mm_setzero_si128()), _mm_unpacklo_epi16(b, _mm_setzero_si128())); }
+			static __m128i widen(__m128i a) { return _mm_cvtepi16_epi32(a); }
+			static __m128i abdl(__m128i a, __m128i b) { return _mm_cvtepu16_epi32(abd(a, b)); }
+
+			static __m128i ceq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+			static __m128i cgt(__m128i a, __m128i b) { return _mm_cmpgt_epi16(a, b); }
+			static __m128i cge(__m128i a, __m128i b) { return not_si128(_mm_cmpgt_epi16(b, a)); }
+
+			static __m128i qadd(__m128i a, __m128i b) { __m128i r = _mm_adds_epi16(a, b); qc_unless(_mm_cmpeq_epi16(r, _mm_add_epi16(a, b))); return r; }
+			static __m128i qsub(__m128i a, __m128i b) { __m128i r = _mm_subs_epi16(a, b); qc_unless(_mm_cmpeq_epi16(r, _mm_sub_epi16(a, b))); return r; }
+			static __m128i qabs(__m128i a) { qc_if(_mm_cmpeq_epi16(a, _mm_set1_epi16(INT16_MIN))); return _mm_min_epu16(_mm_abs_epi16(a), _mm_set1_epi16(-(INT16_MIN + 1))); }
+			static __m128i qneg(__m128i a) { qc_if(_mm_cmpeq_epi16(a, _mm_set1_epi16(INT16_MIN))); return _mm_subs_epi16(_mm_setzero_si128(), a); }
+
+			static __m128i qdmulh(__m128i a, __m128i b) { return fix_min_epi16(_mm_or_si128(_mm_slli_epi16(_mm_mulhi_epi16(a, b), 1), _mm_srli_epi16(_mm_mullo_epi16(a, b), 15))); }
+			static __m128i qrdmulh(__m128i a, __m128i b) { return fix_min_epi16(_mm_mulhrs_epi16(a, b)); }
+
+			template <size_t N> static __m128i addv(__m128i a) { return hsum_epi32<N / 2>(_mm_madd_epi16(a, _mm_set1_epi16(1))); }
+			template <size_t N> static __m128i addlv(__m128i a) { return addv<N>(a); }
+			template <size_t N> static __m128i maxv(__m128i a) { return _mm_xor_si128(_mm_minpos_epu16(_mm_xor_si128(a, _mm_set1_epi16(INT16_MAX))), _mm_set1_epi16(INT16_MAX)); }
+			template <size_t N> static __m128i minv(__m128i a) { return _mm_xor_si128(_mm_minpos_epu16(_mm_xor_si128(a, _mm_set1_epi16(INT16_MIN))), _mm_set1_epi16(INT16_MIN)); }
+			static __m128i padd(__m128i a, __m128i b) { return _mm_hadd_epi16(a, b); }
+			static __m128i paddl(__m128i a) { return _mm_madd_epi16(a, _mm_set1_epi16(1)); }
+
+			template <int N> static __m128i shl(__m128i a) { return _mm_slli_epi16(a, N); }
+			template <int N> static __m128i shr(__m128i a) { return _mm_srai_epi16(a, N); }
+			template <int N> static __m128i srl(__m128i a) { return _mm_srli_epi16(a, N); }
+			static __m128i narrow(__m128i a) { return _mm_shuffle_epi8(a, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1)); }
+			static __m128i qnarrow(__m128i a) { __m128i r = _mm_packs_epi16(a, a); qc_unless(_mm_cmpeq_epi16(_mm_cvtepi8_epi16(r), a)); return r; }
+			static __m128i qnarrowu(__m128i a) { __m128i r = _mm_packus_epi16(a, a); qc_unless(_mm_cmpeq_epi16(_mm_cvtepu8_epi16(r), a)); return r; }
+			static __m128i count(__m128i c) { return _mm_srai_epi16(_mm_slli_epi16(c, 8), 8); }
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+			static __m128i shlv(__m128i a, __m128i n) { return _mm_sllv_epi16(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return _mm_srav_epi16(a, n); }
+#elif NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+			static __m128i shlv(__m128i a, __m128i n) { return shiftv_epi16<shiftv::left>(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return shiftv_epi16<shiftv::arithmetic>(a, n); }
+#endif
+		};
+
+		template <>
+		struct lanes<uint16_t> : compare_ops<lanes<uint16_t>, uint16_t>, bitwise_ops, shift_ops<lanes<uint16_t>, uint16_t>, halving_ops<lanes<uint16_t>, uint16_t>
+		{
+			static __m128i add(__m128i a, __m128i b) { return _mm_add_epi16(a, b); }
+			static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi16(a, b); }
+			static __m128i abd(__m128i a, __m128i b) { return _mm_sub_epi16(_mm_max_epu16(a, b), _mm_min_epu16(a, b)); }
+
+			static __m128i mul(__m128i a, __m128i b) { return _mm_mullo_epi16(a, b); }
+			static __m128i mull(__m128i a, __m128i b) { return _mm_unpacklo_epi16(_mm_mullo_epi16(a, b), _mm_mulhi_epu16(a, b)); }
+			static __m128i widen(__m128i a) { return _mm_cvtepu16_epi32(a); }
+			static __m128i abdl(__m128i a, __m128i b) { return _mm_cvtepu16_epi32(abd(a, b)); }
+
+			static __m128i ceq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+			static __m128i cgt(__m128i a, __m128i b) { return _mm_cmpgt_epi16(_mm_xor_si128(a, _mm_set1_epi16(INT16_MIN)), _mm_xor_si128(b, _mm_set1_epi16(INT16_MIN))); }
+			static __m128i cge(__m128i a, __m128i b) { return _mm_cmpeq_epi16(_mm_max_epu16(a, b), a); }
+
+			static __m128i qadd(__m128i a, __m128i b) { __m128i r = _mm_adds_epu16(a, b); qc_unless(_mm_cmpeq_epi16(r, _mm_add_epi16(a, b))); return r; }
+			static __m128i qsub(__m128i a, __m128i b) { __m128i r = _mm_subs_epu16(a, b); qc_unless(_mm_cmpeq_epi16(r, _mm_sub_epi16(a, b))); return r; }
+
+			template <size_t N> static __m128i addv(__m128i a) { return hsum_epi32<N / 2>(_mm_madd_epi16(a, _mm_set1_epi16(1))); }
+			template <size_t N> static __m128i addlv(__m128i a) { return _mm_add_epi32(hsum_epi32<N / 2>(_mm_madd_epi16(_mm_xor_si128(a, _mm_set1_epi16(INT16_MIN)), _mm_set1_epi16(1))), _mm_set1_epi32(32768 * N)); }
+			template <size_t N> static __m128i maxv(__m128i a) { return not_si128(_mm_minpos_epu16(not_si128(a))); }
+			template <size_t N> static __m128i minv(__m128i a) { return _mm_minpos_epu16(a); }
+			static __m128i padd(__m128i a, __m128i b) { return _mm_hadd_epi16(a, b); }
+			static __m128i paddl(__m128i a) { return _mm_add_epi32(_mm_madd_epi16(_mm_xor_si128(a, _mm_set1_epi16(INT16_MIN)), _mm_set1_epi16(1)), _mm_set1_epi32(0x10000)); }
+
+			template <int N> static __m128i shl(__m128i a) { return _mm_slli_epi16(a, N); }
+			template <int N> static __m128i shr(__m128i a) { return _mm_srli_epi16(a, N); }
+			template <int N> static __m128i srl(__m128i a) { return _mm_srli_epi16(a, N); }
+			static __m128i narrow(__m128i a) { return _mm_shuffle_epi8(a, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1)); }
+			static __m128i qnarrow(__m128i a) { __m128i m = _mm_min_epu16(a, _mm_set1_epi16(0xff)); qc_unless(_mm_cmpeq_epi16(m, a)); return _mm_packus_epi16(m, m); }
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+			static __m128i shlv(__m128i a, __m128i n) { return _mm_sllv_epi16(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return _mm_srlv_epi16(a, n); }
+#elif NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+			static __m128i shlv(__m128i a, __m128i n) { return shiftv_epi16<shiftv::left>(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return shiftv_epi16<shiftv::logical>(a, n); }
+#endif
+		};
+
+		template <>
+		struct lanes<int32_t> : compare_ops<lanes<int32_t>, int32_t>, bitwise_ops, shift_ops<lanes<int32_t>, int32_t>, halving_ops<lanes<int32_t>, int32_t>
+		{
+			static __m128i add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+			static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }
+			static __m128i abd(__m128i a, __m128i b) { return _mm_sub_epi32(_mm_max_epi32(a, b), _mm_min_epi32(a, b)); }
+			static __m128i abs(__m128i a) { return _mm_abs_epi32(a); }
+
+			static __m128i mul(__m128i a, __m128i b) { return _mm_mullo_epi32(a, b); }
+			static __m128i mull(__m128i a, __m128i b) { return _mm_mul_epi32(_mm_unpacklo_epi32(a, a), _mm_unpacklo_epi32(b, b)); }
+			static __m128i widen(__m128i a) { return _mm_cvtepi32_epi64(a); }
+			static __m128i abdl(__m128i a, __m128i b) { return _mm_cvtepu32_epi64(abd(a, b)); }
+
+			static __m128i ceq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+			static __m128i cgt(__m128i a, __m128i b) { return _mm_cmpgt_epi32(a, b); }
+			static __m128i cge(__m128i a, __m128i b) { return not_si128(_mm_cmpgt_epi32(b, a)); }
+
+			static __m128i qadd(__m128i a, __m128i b) { __m128i r = _mm_add_epi32(a, b); return sat_epi32(r, a, _mm_and_si128(_mm_xor_si128(a, r), _mm_xor_si128(b, r))); }
+			static __m128i qsub(__m128i a, __m128i b) { __m128i r = _mm_sub_epi32(a, b); return sat_epi32(r, a, _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r))); }
+			static __m128i qabs(__m128i a) { qc_if(_mm_cmpeq_epi32(a, _mm_set1_epi32(INT32_MIN))); return _mm_min_epu32(_mm_abs_epi32(a), _mm_set1_epi32(INT32_MAX)); }
+			static __m128i qneg(__m128i a) { return fix_min_epi32(_mm_sub_epi32(_mm_setzero_si128(), a)); }
+			static __m128i qdmulh(__m128i a, __m128i b) { return fix_min_epi32(doubling_mulh_epi32<false>(a, b)); }
+			static __m128i qrdmulh(__m128i a, __m128i b) { return fix_min_epi32(doubling_mulh_epi32<true>(a, b)); }
+
+			static __m128i max(__m128i a, __m128i b) { return _mm_max_epi32(a, b); }
+			static __m128i min(__m128i a, __m128i b) { return _mm_min_epi32(a, b); }
+			template <size_t N> static __m128i addv(__m128i a) { return hsum_epi32<N>(a); }
+			template <size_t N> static __m128i addlv(__m128i a)
+			{
+				__m128i s = _mm_cvtepi32_epi64(a);
+				if (N > 2) s = _mm_add_epi64(s, _mm_cvtepi32_epi64(_mm_unpackhi_epi64(a, a)));
+				return _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+			}
+			template <size_t N> static __m128i maxv(__m128i a) { return fold<4, 16, max>(a); }
+			template <size_t N> static __m128i minv(__m128i a) { return fold<4, 16, min>(a); }
+			static __m128i padd(__m128i a, __m128i b) { return _mm_hadd_epi32(a, b); }
+			static __m128i paddl(__m128i a) { return _mm_add_epi64(_mm_cvtepi32_epi64(_mm_shuffle_epi32(a, 0x08)), _mm_cvtepi32_epi64(_mm_shuffle_epi32(a, 0x0d))); }
+
+			template <int N> static __m128i shl(__m128i a) { return _mm_slli_epi32(a, N); }
+			template <int N> static __m128i shr(__m128i a) { return _mm_srai_epi32(a, N); }
+			template <int N> static __m128i srl(__m128i a) { return _mm_srli_epi32(a, N); }
+			static __m128i narrow(__m128i a) { return _mm_shuffle_epi8(a, _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1)); }
+			static __m128i qnarrow(__m128i a) { __m128i r = _mm_packs_epi32(a, a); qc_unless(_mm_cmpeq_epi32(_mm_cvtepi16_epi32(r), a)); return r; }
+			static __m128i qnarrowu(__m128i a) { __m128i r = _mm_packus_epi32(a, a); qc_unless(_mm_cmpeq_epi32(_mm_cvtepu16_epi32(r), a)); return r; }
+			static __m128i count(__m128i c) { return _mm_srai_epi32(_mm_slli_epi32(c, 24), 24); }
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+			static __m128i shlv(__m128i a, __m128i n) { return _mm_sllv_epi32(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return _mm_srav_epi32(a, n); }
+#endif
+		};
+
+		template <>
+		struct lanes<uint32_t> : compare_ops<lanes<uint32_t>, uint32_t>, bitwise_ops, shift_ops<lanes<uint32_t>, uint32_t>, halving_ops<lanes<uint32_t>, uint32_t>
+		{
+			static __m128i add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+			static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }
+			static __m128i abd(__m128i a, __m128i b) { return _mm_sub_epi32(_mm_max_epu32(a, b), _mm_min_epu32(a, b)); }
+
+			static __m128i mul(__m128i a, __m128i b) { return _mm_mullo_epi32(a, b); }
+			static __m128i mull(__m128i a, __m128i b) { return _mm_mul_epu32(_mm_unpacklo_epi32(a, a), _mm_unpacklo_epi32(b, b)); }
+			static __m128i widen(__m128i a) { return _mm_cvtepu32_epi64(a); }
+			static __m128i abdl(__m128i a, __m128i b) { return _mm_cvtepu32_epi64(abd(a, b)); }
+
+			static __m128i ceq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+			static __m128i cgt(__m128i a, __m128i b) { return _mm_cmpgt_epi32(_mm_xor_si128(a, _mm_set1_epi32(INT32_MIN)), _mm_xor_si128(b, _mm_set1_epi32(INT32_MIN))); }
+			static __m128i cge(__m128i a, __m128i b) { return _mm_cmpeq_epi32(_mm_max_epu32(a, b), a); }
+
+			static __m128i qadd(__m128i a, __m128i b) { __m128i m = _mm_min_epu32(a, not_si128(b)); qc_unless(_mm_cmpeq_epi32(m, a)); return _mm_add_epi32(m, b); }
+			static __m128i qsub(__m128i a, __m128i b) { __m128i m = _mm_max_epu32(a, b); qc_unless(_mm_cmpeq_epi32(m, a)); return _mm_sub_epi32(m, b); }
+
+			static __m128i max(__m128i a, __m128i b) { return _mm_max_epu32(a, b); }
+			static __m128i min(__m128i a, __m128i b) { return _mm_min_epu32(a, b); }
+			template <size_t N> static __m128i addv(__m128i a) { return hsum_epi32<N>(a); }
+			template <size_t N> static __m128i addlv(__m128i a)
+			{
+				__m128i s = _mm_cvtepu32_epi64(a);
+				if (N > 2) s = _mm_add_epi64(s, _mm_cvtepu32_epi64(_mm_unpackhi_epi64(a, a)));
+				return _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+			}
+			template <size_t N> static __m128i maxv(__m128i a) { return fold<4, 16, max>(a); }
+			template <size_t N> static __m128i minv(__m128i a) { return fold<4, 16, min>(a); }
+			static __m128i padd(__m128i a, __m128i b) { return _mm_hadd_epi32(a, b); }
+			static __m128i paddl(__m128i a) { return _mm_add_epi64(_mm_and_si128(a, _mm_set1_epi64x(0xffffffff)), _mm_srli_epi64(a, 32)); }
+
+			template <int N> static __m128i shl(__m128i a) { return _mm_slli_epi32(a, N); }
+			template <int N> static __m128i shr(__m128i a) { return _mm_srli_epi32(a, N); }
+			template <int N> static __m128i srl(__m128i a) { return _mm_srli_epi32(a, N); }
+			static __m128i narrow(__m128i a) { return _mm_shuffle_epi8(a, _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1)); }
+			static __m128i qnarrow(__m128i a) { __m128i m = _mm_min_epu32(a, _mm_set1_epi32(0xffff)); qc_unless(_mm_cmpeq_epi32(m, a)); return _mm_packus_epi32(m, m); }
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+			static __m128i shlv(__m128i a, __m128i n) { return _mm_sllv_epi32(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return _mm_srlv_epi32(a, n); }
+#endif
+		};
+
+		template <>
+		struct lanes<int64_t> : compare_ops<lanes<int64_t>, int64_t>, bitwise_ops, shift_ops<lanes<int64_t>, int64_t>
+		{
+			static __m128i add(__m128i a, __m128i b) { return _mm_add_epi64(a, b); }
+			static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi64(a, b); }
+			static __m128i abd(__m128i a, __m128i b)
+			{
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+				return _mm_sub_epi64(_mm_max_epi64(a, b), _mm_min_epi64(a, b));
+#else
+				return cneg_epi64(_mm_sub_epi64(a, b), _mm_cmpgt_epi64(b, a));
+#endif
+			}
+			static __m128i abs(__m128i a)
+			{
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+				return _mm_abs_epi64(a);
+#else
+				return cneg_epi64(a, _mm_cmpgt_epi64(_mm_setzero_si128(), a));
+#endif
+			}
+
+			static __m128i ceq(__m128i a, __m128i b) { return _mm_cmpeq_epi64(a, b); }
+			static __m128i cgt(__m128i a, __m128i b) { return _mm_cmpgt_epi64(a, b); }
+			static __m128i cge(__m128i a, __m128i b) { return not_si128(_mm_cmpgt_epi64(b, a)); }
+
+			static __m128i qadd(__m128i a, __m128i b) { __m128i r = _mm_add_epi64(a, b); return sat_epi64(r, a, _mm_and_si128(_mm_xor_si128(a, r), _mm_xor_si128(b, r))); }
+			static __m128i qsub(__m128i a, __m128i b) { __m128i r = _mm_sub_epi64(a, b); return sat_epi64(r, a, _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r))); }
+			static __m128i qabs(__m128i a) { __m128i m = _mm_cmpeq_epi64(a, _mm_set1_epi64x(INT64_MIN)); qc_if(m); return _mm_xor_si128(abs(a), m); }
+			static __m128i qneg(__m128i a) { __m128i m = _mm_cmpeq_epi64(a, _mm_set1_epi64x(INT64_MIN)); qc_if(m); return _mm_xor_si128(_mm_sub_epi64(_mm_setzero_si128(), a), m); }
+
+			template <size_t N> static __m128i addv(__m128i a) { return N > 1 ? _mm_add_epi64(a, _mm_unpackhi_epi64(a, a)) : a; }
+			static __m128i padd(__m128i a, __m128i b) { return _mm_add_epi64(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b)); }
+
+			template <int N> static __m128i shl(__m128i a) { return _mm_slli_epi64(a, N); }
+			template <int N> static __m128i shr(__m128i a) { return srai_epi64<N>(a); }
+			template <int N> static __m128i srl(__m128i a) { return _mm_srli_epi64(a, N); }
+			static __m128i narrow(__m128i a) { return _mm_shuffle_epi32(a, 0x08); }
+			static __m128i qnarrow(__m128i a)
+			{
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+				__m128i r = _mm_maskz_cvtsepi64_epi32(0xff, a);
+				qc_unless(_mm_cmpeq_epi64(_mm_cvtepi32_epi64(r), a));
+				return r;
+#else
+				const __m128i max = _mm_set1_epi64x(INT32_MAX), min = _mm_set1_epi64x(INT32_MIN);
+				__m128i c = _mm_blendv_epi8(a, max, _mm_cmpgt_epi64(a, max));
+				c = _mm_blendv_epi8(c, min, _mm_cmpgt_epi64(min, c));
+				qc_unless(_mm_cmpeq_epi64(c, a));
+				return narrow(c);
+#endif
+			}
+			static __m128i qnarrowu(__m128i a)
+			{
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+				__m128i c = _mm_min_epu64(_mm_max_epi64(a, _mm_setzero_si128()), _mm_set1_epi64x(0xffffffff));
+				qc_unless(_mm_cmpeq_epi64(c, a));
+				return narrow(c);
+#else
+				__m128i negative = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
+				__m128i over = _mm_cmpgt_epi64(a, _mm_set1_epi64x(0xffffffff));
+				qc_if(_mm_or_si128(negative, over));
+				return narrow(_mm_or_si128(_mm_andnot_si128(negative, a), over));
+#endif
+			}
+			static __m128i count(__m128i c) { return _mm_cvtepi8_epi64(_mm_shuffle_epi8(c, _mm_setr_epi8(0, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1))); }
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+			static __m128i shlv(__m128i a, __m128i n) { return _mm_sllv_epi64(a, n); }
+			static __m128i shrv(__m128i a, __m128i n)
+			{
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+				return _mm_srav_epi64(a, n);
+#else
+				__m128i s = _mm_cmpgt_epi64(_mm_setzero_si128(), a);
+				return _mm_xor_si128(_mm_srlv_epi64(_mm_xor_si128(a, s), n), s);
+#endif
+			}
+#endif
+		};
+
+		template <>
+		struct lanes<uint64_t> : compare_ops<lanes<uint64_t>, uint64_t>, bitwise_ops, shift_ops<lanes<uint64_t>, uint64_t>
+		{
+			static __m128i add(__m128i a, __m128i b) { return _mm_add_epi64(a, b); }
+			static __m128i sub(__m128i a, __m128i b) { return _mm_sub_epi64(a, b); }
+			static __m128i abd(__m128i a, __m128i b)
+			{
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+				return _mm_sub_epi64(_mm_max_epu64(a, b), _mm_min_epu64(a, b));
+#else
+				return cneg_epi64(_mm_sub_epi64(a, b), cmpgt_epu64(b, a));
+#endif
+			}
+
+			static __m128i ceq(__m128i a, __m128i b) { return _mm_cmpeq_epi64(a, b); }
+			static __m128i cgt(__m128i a, __m128i b) { return cmpgt_epu64(a, b); }
+			static __m128i cge(__m128i a, __m128i b) { return not_si128(cmpgt_epu64(b, a)); }
+
+			static __m128i qadd(__m128i a, __m128i b) { __m128i r = _mm_add_epi64(a, b); __m128i m = cmpgt_epu64(a, r); qc_if(m); return _mm_or_si128(r, m); }
+			static __m128i qsub(__m128i a, __m128i b) { __m128i m = cmpgt_epu64(b, a); qc_if(m); return _mm_andnot_si128(m, _mm_sub_epi64(a, b)); }
+
+			template <size_t N> static __m128i addv(__m128i a) { return N > 1 ? _mm_add_epi64(a, _mm_unpackhi_epi64(a, a)) : a; }
+			static __m128i padd(__m128i a, __m128i b) { return _mm_add_epi64(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b)); }
+
+			template <int N> static __m128i shl(__m128i a) { return _mm_slli_epi64(a, N); }
+			template <int N> static __m128i shr(__m128i a) { return _mm_srli_epi64(a, N); }
+			template <int N> static __m128i srl(__m128i a) { return _mm_srli_epi64(a, N); }
+			static __m128i narrow(__m128i a) { return _mm_shuffle_epi32(a, 0x08); }
+			static __m128i qnarrow(__m128i a)
+			{
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512
+				__m128i r = _mm_maskz_cvtusepi64_epi32(0xff, a);
+				qc_unless(_mm_cmpeq_epi64(_mm_cvtepu32_epi64(r), a));
+				return r;
+#else
+				__m128i m = cmpgt_epu64(a, _mm_set1_epi64x(0xffffffff));
+				qc_if(m);
+				return narrow(_mm_or_si128(a, m));
+#endif
+			}
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+			static __m128i shlv(__m128i a, __m128i n) { return _mm_sllv_epi64(a, n); }
+			static __m128i shrv(__m128i a, __m128i n) { return _mm_srlv_epi64(a, n); }
+#endif
+		};
+
+		template <>
+		struct lanes<float32_t> : compare_ops<lanes<float32_t>, float32_t>, bitwise_ops
+		{
+			static __m128 f(__m128i a) { return _mm_castsi128_ps(a); }
+			static __m128i i(__m128 a) { return _mm_castps_si128(a); }
+
+			static __m128i add(__m128i a, __m128i b) { return i(_mm_add_ps(f(a), f(b))); }
+			static __m128i sub(__m128i a, __m128i b) { return i(_mm_sub_ps(f(a), f(b))); }
+			static __m128i abd(__m128i a, __m128i b) { return abs(i(_mm_sub_ps(f(a), f(b)))); }
+			static __m128i abs(__m128i a) { return i(_mm_andnot_ps(_mm_set1_ps(-0.0f), f(a))); }
+
+			static __m128i mul(__m128i a, __m128i b) { return i(unfused(_mm_mul_ps(f(a), f(b)))); }
+#if defined(NEON_X86_FMA)
+			static __m128i fma(__m128i a, __m128i b, __m128i c) { return i(_mm_fmadd_ps(f(b), f(c), f(a))); }
+			static __m128i fms(__m128i a, __m128i b, __m128i c) { return i(_mm_fnmadd_ps(f(b), f(c), f(a))); }
+#endif
+
+			// Ordered predicates: any NaN operand gives an all-zeros lane.
+			static __m128i ceq(__m128i a, __m128i b) { return i(_mm_cmpeq_ps(f(a), f(b))); }
+			static __m128i cgt(__m128i a, __m128i b) { return i(_mm_cmpgt_ps(f(a), f(b))); }
+			static __m128i cge(__m128i a, __m128i b) { return i(_mm_cmpge_ps(f(a), f(b))); }
+
+			static __m128i cage(__m128i a, __m128i b) { return cge(abs(a), abs(b)); }
+			static __m128i cagt(__m128i a, __m128i b) { return cgt(abs(a), abs(b)); }
+			static __m128i cale(__m128i a, __m128i b) { return cage(b, a); }
+			static __m128i calt(__m128i a, __m128i b) { return cagt(b, a); }
+
+			// ARM FMAX/FMIN. x86 returns the second operand for NaNs and for equal
+			// operands; combining both operand orders fixes the sign of zero, and NaN
+			// lanes are patched with a + b. The nm forms return the other operand.
+			static __m128i max(__m128i a, __m128i b) { __m128 x = f(a), y = f(b); return i(_mm_blendv_ps(_mm_and_ps(_mm_max_ps(x, y), _mm_max_ps(y, x)), _mm_add_ps(x, y), _mm_cmpunord_ps(x, y))); }
+			static __m128i min(__m128i a, __m128i b) { __m128 x = f(a), y = f(b); return i(_mm_blendv_ps(_mm_or_ps(_mm_min_ps(x, y), _mm_min_ps(y, x)), _mm_add_ps(x, y), _mm_cmpunord_ps(x, y))); }
+			static __m128i maxnm(__m128i a, __m128i b) { __m128 x = f(a), y = f(b); __m128 r = _mm_blendv_ps(_mm_and_ps(_mm_max_ps(x, y), _mm_max_ps(y, x)), y, _mm_cmpunord_ps(x, x)); return i(_mm_blendv_ps(r, x, _mm_cmpunord_ps(y, y))); }
+			static __m128i minnm(__m128i a, __m128i b) { __m128 x = f(a), y = f(b); __m128 r = _mm_blendv_ps(_mm_or_ps(_mm_min_ps(x, y), _mm_min_ps(y, x)), y, _mm_cmpunord_ps(x, x)); return i(_mm_blendv_ps(r, x, _mm_cmpunord_ps(y, y))); }
+
+			// Sums keep ARM's faddp order, (a0 + a1) + (a2 + a3).
+			template <size_t N> static __m128i addv(__m128i a)
+			{
+				__m128 v = f(a);
+				if (N == 2) return i(_mm_add_ss(v, _mm_movehdup_ps(v)));
+				v = _mm_add_ps(v, _mm_movehdup_ps(v));
+				return i(_mm_add_ss(v, _mm_movehl_ps(v, v)));
+			}
+			template <size_t N> static __m128i maxv(__m128i a) { return fold<4, 16, max>(a); }
+			template <size_t N> static __m128i minv(__m128i a) { return fold<4, 16, min>(a); }
+			template <size_t N> static __m128i maxnmv(__m128i a) { return fold<4, 16, maxnm>(a); }
+			template <size_t N> static __m128i minnmv(__m128i a) { return fold<4, 16, minnm>(a); }
+			static __m128i padd(__m128i a, __m128i b) { return i(_mm_hadd_ps(f(a), f(b))); }
+
+			// Width changes to and from float64; narrowing fills the low half.
+			static __m128i cvtl(__m128i a) { return _mm_castpd_si128(_mm_cvtps_pd(f(a))); }
+			static __m128i cvtn(__m128i a) { return i(_mm_cvtpd_ps(_mm_castsi128_pd(a))); }
+		};
+
+		template <>
+		struct lanes<float64_t> : compare_ops<lanes<float64_t>, float64_t>, bitwise_ops
+		{
+			static __m128d f(__m128i a) { return _mm_castsi128_pd(a); }
+			static __m128i i(__m128d a) { return _mm_castpd_si128(a); }
+
+			static __m128i add(__m128i a, __m128i b) { return i(_mm_add_pd(f(a), f(b))); }
+			static __m128i sub(__m128i a, __m128i b) { return i(_mm_sub_pd(f(a), f(b))); }
+			static __m128i abd(__m128i a, __m128i b) { return abs(i(_mm_sub_pd(f(a), f(b)))); }
+			static __m128i abs(__m128i a) { return i(_mm_andnot_pd(_mm_set1_pd(-0.0), f(a))); }
+
+			static __m128i mul(__m128i a, __m128i b) { return i(unfused(_mm_mul_pd(f(a), f(b)))); }
+#if defined(NEON_X86_FMA)
+			static __m128i fma(__m128i a, __m128i b, __m128i c) { return i(_mm_fmadd_pd(f(b), f(c), f(a))); }
+			static __m128i fms(__m128i a, __m128i b, __m128i c) { return i(_mm_fnmadd_pd(f(b), f(c), f(a))); }
+#endif
+
+			// Ordered predicates: any NaN operand gives an all-zeros lane.
+			static __m128i ceq(__m128i a, __m128i b) { return i(_mm_cmpeq_pd(f(a), f(b))); }
+			static __m128i cgt(__m128i a, __m128i b) { return i(_mm_cmpgt_pd(f(a), f(b))); }
+			static __m128i cge(__m128i a, __m128i b) { return i(_mm_cmpge_pd(f(a), f(b))); }
+
+			static __m128i cage(__m128i a, __m128i b) { return cge(abs(a), abs(b)); }
+			static __m128i cagt(__m128i a, __m128i b) { return cgt(abs(a), abs(b)); }
+			static __m128i cale(__m128i a, __m128i b) { return cage(b, a); }
+			static __m128i calt(__m128i a, __m128i b) { return cagt(b, a); }
+
+			static __m128i max(__m128i a, __m128i b) { __m128d x = f(a), y = f(b); return i(_mm_blendv_pd(_mm_and_pd(_mm_max_pd(x, y), _mm_max_pd(y, x)), _mm_add_pd(x, y), _mm_cmpunord_pd(x, y))); }
+			static __m128i min(__m128i a, __m128i b) { __m128d x = f(a), y = f(b); return i(_mm_blendv_pd(_mm_or_pd(_mm_min_pd(x, y), _mm_min_pd(y, x)), _mm_add_pd(x, y), _mm_cmpunord_pd(x, y))); }
+			static __m128i maxnm(__m128i a, __m128i b) { __m128d x = f(a), y = f(b); __m128d r = _mm_blendv_pd(_mm_and_pd(_mm_max_pd(x, y), _mm_max_pd(y, x)), y, _mm_cmpunord_pd(x, x)); return i(_mm_blendv_pd(r, x, _mm_cmpunord_pd(y, y))); }
+			static __m128i minnm(__m128i a, __m128i b) { __m128d x = f(a), y = f(b); __m128d r = _mm_blendv_pd(_mm_or_pd(_mm_min_pd(x, y), _mm_min_pd(y, x)), y, _mm_cmpunord_pd(x, x)); return i(_mm_blendv_pd(r, x, _mm_cmpunord_pd(y, y))); }
+
+			template <size_t N> static __m128i addv(__m128i a) { return N > 1 ? i(_mm_add_sd(f(a), _mm_unpackhi_pd(f(a), f(a)))) : a; }
+			template <size_t N> static __m128i maxv(__m128i a) { return fold<8, 16, max>(a); }
+			template <size_t N> static __m128i minv(__m128i a) { return fold<8, 16, min>(a); }
+			template <size_t N> static __m128i maxnmv(__m128i a) { return fold<8, 16, maxnm>(a); }
+			template <size_t N> static __m128i minnmv(__m128i a) { return fold<8, 16, minnm>(a); }
+			static __m128i padd(__m128i a, __m128i b) { return i(_mm_hadd_pd(f(a), f(b))); }
+		};
+
+#if defined(NEON_X86_F16C)
+		// Half-precision lanes are widened with vcvtph2ps, computed as float32 in
+		// one ymm register and rounded back with vcvtps2ph. A single float32 op
+		// rounded once to half gives the same result as the half-precision op,
+		// and compares and min/max are exact in either width.
+		template <>
+		struct lanes<float16_t> : compare_ops<lanes<float16_t>, float16_t>, bitwise_ops
+		{
+			static __m256 f(__m128i a) { return _mm256_cvtph_ps(a); }
+			static __m128i i(__m256 a) { return _mm256_cvtps_ph(a, _MM_FROUND_CUR_DIRECTION); }
+			static __m128i mask(__m256 a) { return _mm_packs_epi32(_mm_castps_si128(_mm256_castps256_ps128(a)), _mm_castps_si128(_mm256_extractf128_ps(a, 1))); }
+
+			static __m128i add(__m128i a, __m128i b) { return i(_mm256_add_ps(f(a), f(b))); }
+			static __m128i sub(__m128i a, __m128i b) { return i(_mm256_sub_ps(f(a), f(b))); }
+			static __m128i abd(__m128i a, __m128i b) { return abs(sub(a, b)); }
+			static __m128i abs(__m128i a) { return _mm_and_si128(a, _mm_set1_epi16(0x7fff)); }
+
+			static __m128i ceq(__m128i a, __m128i b) { return mask(_mm256_cmp_ps(f(a), f(b), _CMP_EQ_OQ)); }
+			static __m128i cgt(__m128i a, __m128i b) { return mask(_mm256_cmp_ps(f(a), f(b), _CMP_GT_OQ)); }
+			static __m128i cge(__m128i a, __m128i b) { return mask(_mm256_cmp_ps(f(a), f(b), _CMP_GE_OQ)); }
+
+			static __m128i cage(__m128i a, __m128i b) { return cge(abs(a), abs(b)); }
+			static __m128i cagt(__m128i a, __m128i b) { return cgt(abs(a), abs(b)); }
+			static __m128i cale(__m128i a, __m128i b) { return cage(b, a); }
+			static __m128i calt(__m128i a, __m128i b) { return cagt(b, a); }
+
+			// The reductions fold the two float32 halves and reuse the float32 folds.
+			template <__m128i (*Op)(__m128i, __m128i)> static __m128i reduce(__m128i a)
+			{
+				__m256 v = f(a);
+				__m128i r = Op(_mm_castps_si128(_mm256_castps256_ps128(v)), _mm_castps_si128(_mm256_extractf128_ps(v, 1)));
+				return cvtn(fold<4, 16, Op>(r));
+			}
+			template <size_t N> static __m128i maxv(__m128i a) { return reduce<lanes<float32_t>::max>(a); }
+			template <size_t N> static __m128i minv(__m128i a) { return reduce<lanes<float32_t>::min>(a); }
+			template <size_t N> static __m128i maxnmv(__m128i a) { return reduce<lanes<float32_t>::maxnm>(a); }
+			template <size_t N> static __m128i minnmv(__m128i a) { return reduce<lanes<float32_t>::minnm>(a); }
+
+			// Width changes to and from float32; narrowing fills the low half.
+			static __m128i cvtl(__m128i a) { return _mm_castps_si128(_mm_cvtph_ps(a)); }
+			static __m128i cvtn(__m128i a) { return _mm_cvtps_ph(_mm_castsi128_ps(a), _MM_FROUND_CUR_DIRECTION); }
+		};
+#endif
+
+		// Structure loads and stores. interleave<Count, Size>::ld de-interleaves
+		// Count registers of Size-byte elements in memory order into one
+		// register per structure member; st is the inverse. The d-register forms
+		// run the same networks on half-filled registers, since the low half of
+		// every output only depends on the first half of memory.
+
+		struct byte_shuffle
+		{
+			alignas(16) int8_t b[16];
+		};
+
+		inline __m128i shuffle(byte_shuffle const& m)
+		{
+			return _mm_load_si128(reinterpret_cast<__m128i const*>(m.b));
+		}
+
+		// pshufb control for ld output register `out`, picking the bytes that
+		// sit in input register `in`; -128 zeroes the others.
+		constexpr byte_shuffle ldn_shuffle(int count, int size, int out, int in)
+		{
+			byte_shuffle m{};
+			for (int b = 0; b < 16; b++)
+			{
+				int off = ((b / size) * count + out) * size + b % size;
+				m.b[b] = off / 16 == in ? int8_t(off % 16) : int8_t(-128);
+			}
+			return m;
+		}
+
+		// pshufb control for st output register `out`, picking the bytes of
+		// structure member `in`.
+		constexpr byte_shuffle stn_shuffle(int count, int size, int out, int in)
+		{
+			byte_shuffle m{};
+			for (int b = 0; b < 16; b++)
+			{
+				int elem = (out * 16 + b) / size;
+				m.b[b] = elem % count == in ? int8_t((elem / count) * size + b % size) : int8_t(-128);
+			}
+			return m;
+		}
+
+		// Regroups the structures inside one register member-major, e.g.
+		// x0 y0 x1 y1 ... into x0 x1 ... y0 y1 ...; unshuffle_members undoes it.
+		constexpr byte_shuffle group_members(int count, int size)
+		{
+			byte_shuffle m{};
+			int n = count * size < 16 ? 16 / (count * size) : 1;
+			for (int b = 0; b < 16; b++)
+			{
+				int member = b / (n * size), elem = (b % (n * size)) / size;
+				m.b[b] = int8_t((elem * count + member) * size + b % size);
+			}
+			return m;
+		}
+
+		constexpr byte_shuffle unshuffle_members(int count, int size)
+		{
+			byte_shuffle m{};
+			int n = count * size < 16 ? 16 / (count * size) : 1;
+			for (int b = 0; b < 16; b++)
+			{
+				int elem = b / size;
+				m.b[b] = int8_t((elem % count) * n * size + (elem / count) * size + b % size);
+			}
+			return m;
+		}
+
+		template <int Count>
+		struct shuffle_table
+		{
+			byte_shuffle m[Count][Count];
+		};
+
+		template <int Count, int Size>
+		constexpr shuffle_table<Count> ldn_table()
+		{
+			shuffle_table<Count> t{};
+			for (int j = 0; j < Count; j++)
+				for (int k = 0; k < Count; k++)
+					t.m[j][k] = ldn_shuffle(Count, Size, j, k);
+			return t;
+		}
+
+		template <int Count, int Size>
+		constexpr shuffle_table<Count> stn_table()
+		{
+			shuffle_table<Count> t{};
+			for (int j = 0; j < Count; j++)
+				for (int k = 0; k < Count; k++)
+					t.m[j][k] = stn_shuffle(Count, Size, j, k);
+			return t;
+		}
+
+		template <int Size>
+		inline __m128i unpacklo(__m128i a, __m128i b)
+		{
+			return Size == 1 ? _mm_unpacklo_epi8(a, b) : Size == 2 ? _mm_unpacklo_epi16(a, b) : Size == 4 ? _mm_unpacklo_epi32(a, b) : _mm_unpacklo_epi64(a, b);
+		}
+
+		template <int Size>
+		inline __m128i unpackhi(__m128i a, __m128i b)
+		{
+			return Size == 1 ? _mm_unpackhi_epi8(a, b) : Size == 2 ? _mm_unpackhi_epi16(a, b) : Size == 4 ? _mm_unpackhi_epi32(a, b) : _mm_unpackhi_epi64(a, b);
+		}
+
+		inline void transpose4x32(__m128i const* in, __m128i* out)
+		{
+			__m128i t0 = _mm_unpacklo_epi32(in[0], in[1]);
+			__m128i t1 = _mm_unpacklo_epi32(in[2], in[3]);
+			__m128i t2 = _mm_unpackhi_epi32(in[0], in[1]);
+			__m128i t3 = _mm_unpackhi_epi32(in[2], in[3]);
+			out[0] = _mm_unpacklo_epi64(t0, t1);
+			out[1] = _mm_unpackhi_epi64(t0, t1);
+			out[2] = _mm_unpacklo_epi64(t2, t3);
+			out[3] = _mm_unpackhi_epi64(t2, t3);
+		}
+
+		template <int Count, int Size>
+		struct interleave;
+
+		// Three-way: every output gathers from all three inputs, one pshufb each.
+		template <int Size>
+		struct interleave<3, Size>
+		{
+			static __m128i gather(__m128i const* in, byte_shuffle const* m)
+			{
+				return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(in[0], shuffle(m[0])), _mm_shuffle_epi8(in[1], shuffle(m[1]))), _mm_shuffle_epi8(in[2], shuffle(m[2])));
+			}
+
+			static void ld(__m128i const* in, __m128i* out)
+			{
+				static constexpr shuffle_table<3> t = ldn_table<3, Size>();
+				out[0] = gather(in, t.m[0]);
+				out[1] = gather(in, t.m[1]);
+				out[2] = gather(in, t.m[2]);
+			}
+
+			static void st(__m128i const* in, __m128i* out)
+			{
+				static constexpr shuffle_table<3> t = stn_table<3, Size>();
+				out[0] = gather(in, t.m[0]);
+				out[1] = gather(in, t.m[1]);
+				out[2] = gather(in, t.m[2]);
+			}
+		};
+
+		template <>
+		struct interleave<3, 8>
+		{
+			static void ld(__m128i const* in, __m128i* out)
+			{
+				out[0] = _mm_blend_epi16(in[0], in[1], 0xf0);
+				out[1] = _mm_alignr_epi8(in[2], in[0], 8);
+				out[2] = _mm_blend_epi16(in[1], in[2], 0xf0);
+			}
+
+			static void st(__m128i const* in, __m128i* out)
+			{
+				out[0] = _mm_unpacklo_epi64(in[0], in[1]);
+				out[1] = _mm_blend_epi16(in[2], in[0], 0xf0);
+				out[2] = _mm_unpackhi_epi64(in[1], in[2]);
+			}
+		};
+
+		template <int Size>
+		struct interleave<2, Size>
+		{
+			static void ld(__m128i const* in, __m128i* out)
+			{
+				if (Size == 4)
+				{
+					__m128 a = _mm_castsi128_ps(in[0]), b = _mm_castsi128_ps(in[1]);
+					out[0] = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+					out[1] = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+					return;
+				}
+				__m128i a = in[0], b = in[1];
+				if (Size < 4)
+				{
+					static constexpr byte_shuffle g = group_members(2, Size);
+					a = _mm_shuffle_epi8(a, shuffle(g));
+					b = _mm_shuffle_epi8(b, shuffle(g));
+				}
+				out[0] = _mm_unpacklo_epi64(a, b);
+				out[1] = _mm_unpackhi_epi64(a, b);
+			}
+
+			static void st(__m128i const* in, __m128i* out)
+			{
+				out[0] = unpacklo<Size>(in[0], in[1]);
+				out[1] = unpackhi<Size>(in[0], in[1]);
+			}
+		};
+
+		template <int Size>
+		struct interleave<4, Size>
+		{
+			static void ld(__m128i const* in, __m128i* out)
+			{
+				if (Size == 8)
+				{
+					out[0] = _mm_unpacklo_epi64(in[0], in[2]);
+					out[1] = _mm_unpackhi_epi64(in[0], in[2]);
+					out[2] = _mm_unpacklo_epi64(in[1], in[3]);
+					out[3] = _mm_unpackhi_epi64(in[1], in[3]);
+					return;
+				}
+				if (Size < 4)
+				{
+					static constexpr byte_shuffle m = group_members(4, Size);
+					__m128i g[4] = { _mm_shuffle_epi8(in[0], shuffle(m)), _mm_shuffle_epi8(in[1], shuffle(m)), _mm_shuffle_epi8(in[2], shuffle(m)), _mm_shuffle_epi8(in[3], shuffle(m)) };
+					transpose4x32(g, out);
+					return;
+				}
+				transpose4x32(in, out);
+			}
+
+			static void st(__m128i const* in, __m128i* out)
+			{
+				if (Size == 8)
+				{
+					out[0] = _mm_unpacklo_epi64(in[0], in[1]);
+					out[1] = _mm_unpacklo_epi64(in[2], in[3]);
+					out[2] = _mm_unpackhi_epi64(in[0], in[1]);
+					out[3] = _mm_unpackhi_epi64(in[2], in[3]);
+					return;
+				}
+				transpose4x32(in, out);
+				if (Size < 4)
+				{
+					static constexpr byte_shuffle m = unshuffle_members(4, Size);
+					out[0] = _mm_shuffle_epi8(out[0], shuffle(m));
+					out[1] = _mm_shuffle_epi8(out[1], shuffle(m));
+					out[2] = _mm_shuffle_epi8(out[2], shuffle(m));
+					out[3] = _mm_shuffle_epi8(out[3], shuffle(m));
+				}
+			}
+		};
+
+		template <typename V, size_t Count>
+		inline neon_tuple<V, Count> ldn(typename V::type const* p)
+		{
+			__m128i in[Count] = {};
+			std::memcpy(in, p, Count * sizeof(V));
+			__m128i out[Count];
+			interleave<Count, sizeof(typename V::type)>::ld(in, out);
+			neon_tuple<V, Count> r;
+			for (size_t j = 0; j < Count; j++)
+				r.val[j] = store<V>(out[j]);
+			return r;
+		}
+
+		template <typename V, size_t Count>
+		inline void stn(typename V::type* p, neon_tuple<V, Count> const& a)
+		{
+			__m128i in[Count];
+			for (size_t j = 0; j < Count; j++)
+				in[j] = load(a.val[j]);
+			__m128i out[Count];
+			interleave<Count, sizeof(typename V::type)>::st(in, out);
+			std::memcpy(p, out, Count * sizeof(V));
+		}
+
+		// Table lookups. The table is pshufb'd one register at a time: the
+		// saturating add sets bit 7, which makes pshufb write 0, for every index
+		// outside the current register.
+		template <size_t Regs>
+		inline __m128i lookup(__m128i const* t, __m128i idx)
+		{
+			__m128i r = _mm_shuffle_epi8(t[0], _mm_adds_epu8(idx, _mm_set1_epi8(0x70)));
+			return _mm_or_si128(r, lookup<Regs - 1>(t + 1, _mm_sub_epi8(idx, _mm_set1_epi8(16))));
+		}
+
+		template <>
+		inline __m128i lookup<0>(__m128i const*, __m128i)
+		{
+			return _mm_setzero_si128();
+		}
+
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX512 && defined(__AVX512VBMI__) && !defined(NEON_X86_NAMESPACE)
+		// vpermi2b looks up 32 bytes at once; lanes past the table are masked
+		// to zero. Only for builds targeting VBMI: the avx512 dispatch target
+		// doesn't include it, and checking the host at run time means calling
+		// out of the avx512 copy into a VBMI-target function, which measured
+		// slower than the pshufb chain. Dispatched code always uses pshufb.
+		template <>
+		inline __m128i lookup<2>(__m128i const* t, __m128i idx)
+		{
+			return _mm_maskz_permutex2var_epi8(_mm_cmplt_epu8_mask(idx, _mm_set1_epi8(32)), t[0], idx, t[1]);
+		}
+
+		template <>
+		inline __m128i lookup<3>(__m128i const* t, __m128i idx)
+		{
+			__m128i r = _mm_permutex2var_epi8(t[0], idx, t[1]);
+			r = _mm_mask_permutexvar_epi8(r, _mm_test_epi8_mask(idx, _mm_set1_epi8(32)), idx, t[2]);
+			return _mm_maskz_mov_epi8(_mm_cmplt_epu8_mask(idx, _mm_set1_epi8(48)), r);
+		}
+
+		template <>
+		inline __m128i lookup<4>(__m128i const* t, __m128i idx)
+		{
+			__m128i lo = _mm_permutex2var_epi8(t[0], idx, t[1]);
+			__m128i hi = _mm_permutex2var_epi8(t[2], idx, t[3]);
+			__m128i r = _mm_mask_blend_epi8(_mm_test_epi8_mask(idx, _mm_set1_epi8(32)), lo, hi);
+			return _mm_maskz_mov_epi8(_mm_cmplt_epu8_mask(idx, _mm_set1_epi8(64)), r);
+		}
+#endif
+
+		// q-register tables load as they are; d-register tables are packed two
+		// to a register, leaving the tail of vtbl1/vtbl3 tables zero so they
+		// need no extra range check. Recursive rather than a loop, which -O2
+		// would leave rolled with the table spilled to the stack.
+		template <size_t J = 0, typename V, size_t Count>
+		inline typename std::enable_if<(J >= Count)>::type
+			pack(neon_tuple<V, Count> const&, __m128i*)
+		{
+		}
+
+		template <size_t J = 0, typename T, size_t Count>
+		inline typename std::enable_if<(J < Count)>::type
+			pack(neon_tuple<neon128<T>, Count> const& a, __m128i* t)
+		{
+			t[J] = load(a.val[J]);
+			pack<J + 1>(a, t);
+		}
+
+		template <size_t J = 0, typename T, size_t Count>
+		inline typename std::enable_if<(J + 1 == Count)>::type
+			pack(neon_tuple<neon64<T>, Count> const& a, __m128i* t)
+		{
+			t[J / 2] = load(a.val[J]);
+		}
+
+		template <size_t J = 0, typename T, size_t Count>
+		inline typename std::enable_if<(J + 1 < Count)>::type
+			pack(neon_tuple<neon64<T>, Count> const& a, __m128i* t)
+		{
+			t[J / 2] = _mm_unpacklo_epi64(load(a.val[J]), load(a.val[J + 1]));
+			pack<J + 2>(a, t);
+		}
+
+		template <typename R, typename Table>
+		inline R tbl(Table const& a, __m128i idx)
+		{
+			constexpr size_t regs = (sizeof(Table) + 15) / 16;
+			__m128i t[regs];
+			pack(a, t);
+			return store<R>(lookup<regs>(t, idx));
+		}
+
+		template <typename R, typename Table>
+		inline R tbx(__m128i a, Table const& b, __m128i idx)
+		{
+			constexpr size_t regs = (sizeof(Table) + 15) / 16;
+			__m128i t[regs];
+			pack(b, t);
+			__m128i outside = _mm_cmpeq_epi8(_mm_max_epu8(idx, _mm_set1_epi8(char(sizeof(Table)))), idx);
+			return store<R>(_mm_blendv_epi8(lookup<regs>(t, idx), a, outside));
+		}
+
+		// Permutations of Size-byte lanes; Bytes is the register width. The d
+		// forms see registers with a zero upper half, so zip2 and uzp put both
+		// operands into one register and take its upper half where needed.
+		constexpr byte_shuffle reverse_shuffle(int group, int size)
+		{
+			byte_shuffle m{};
+			for (int b = 0; b < 16; b++)
+				m.b[b] = int8_t(b / group * group + (group / size - 1 - b % group / size) * size + b % size);
+			return m;
+		}
+
+		template <size_t Size>
+		struct permute
+		{
+			// Even lanes to the low half, odd lanes to the high half.
+			static __m128i evens_first(__m128i a)
+			{
+				static constexpr byte_shuffle m = group_members(2, Size);
+				return Size == 8 ? a : _mm_shuffle_epi8(a, shuffle(m));
+			}
+
+			// b moved up one lane within each pair of lanes, then the odd lanes
+			// of b blended over a.
+			static __m128i up(__m128i b) { return Size == 1 ? _mm_slli_epi16(b, 8) : Size == 2 ? _mm_slli_epi32(b, 16) : Size == 4 ? _mm_slli_epi64(b, 32) : _mm_slli_si128(b, 8); }
+			static __m128i down(__m128i a) { return Size == 1 ? _mm_srli_epi16(a, 8) : Size == 2 ? _mm_srli_epi32(a, 16) : Size == 4 ? _mm_srli_epi64(a, 32) : _mm_srli_si128(a, 8); }
+			static __m128i odd(__m128i a, __m128i b) { return Size == 1 ? _mm_blendv_epi8(a, b, _mm_set1_epi16(short(0xff00))) : _mm_blend_epi16(a, b, Size == 2 ? 0xaa : Size == 4 ? 0xcc : 0xf0); }
+
+			template <size_t Bytes> static __m128i zip1(__m128i a, __m128i b) { return unpacklo<Size>(a, b); }
+			template <size_t Bytes> static __m128i zip2(__m128i a, __m128i b) { return Bytes == 16 ? unpackhi<Size>(a, b) : high(unpacklo<Size>(a, b)); }
+
+			template <size_t Bytes> static __m128i uzp1(__m128i a, __m128i b)
+			{
+				if (Bytes == 16)
+					return Size == 4 ? _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), 0x88)) : _mm_unpacklo_epi64(evens_first(a), evens_first(b));
+				return Size == 4 ? _mm_unpacklo_epi32(a, b) : evens_first(_mm_unpacklo_epi64(a, b));
+			}
+
+			template <size_t Bytes> static __m128i uzp2(__m128i a, __m128i b)
+			{
+				if (Bytes == 16)
+					return Size == 4 ? _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), 0xdd)) : _mm_unpackhi_epi64(evens_first(a), evens_first(b));
+				return Size == 4 ? high(_mm_unpacklo_epi32(a, b)) : high(evens_first(_mm_unpacklo_epi64(a, b)));
+			}
+
+			template <size_t Bytes> static __m128i trn1(__m128i a, __m128i b) { return odd(a, up(b)); }
+			template <size_t Bytes> static __m128i trn2(__m128i a, __m128i b) { return odd(down(a), b); }
+
+			template <int N, size_t Bytes> static __m128i ext(__m128i a, __m128i b) { return Bytes == 16 ? _mm_alignr_epi8(b, a, N * Size) : _mm_srli_si128(_mm_unpacklo_epi64(a, b), N * Size); }
+
+			template <int Group> static __m128i rev(__m128i a)
+			{
+				static constexpr byte_shuffle m = reverse_shuffle(Group, Size);
+				return Size == 4 && Group == 8 ? _mm_shuffle_epi32(a, 0xb1) : _mm_shuffle_epi8(a, shuffle(m));
+			}
+		};
+
+	} // namespace x86
+
+	// vdup_lane is a template on the lane, so instead of a non-template
+	// overload these are more specialized templates: neon::vdup_lane<L, R>
+	// picks them, neon::vdup_lane<L, R, V> still names the scalar loop (the
+	// enable_if rejects a register type as T before the parameters are formed).
+	template <int Lane, typename R, typename T, typename std::enable_if<is_integer<T>::value || is_ieee754<T>::value, int>::type = 0>
+	inline R vdup_lane(neon64<T> const& a)
+	{
+		static_assert(Lane >= 0 && Lane < neon64<T>::N, "lane out of range");
+		static_assert(std::is_same<typename R::type, T>::value, "lane type mismatch");
+		return x86::store<R>(x86::broadcast<sizeof(T)>::template lane<Lane>(x86::load(a)));
+	}
+
+	template <int Lane, typename R, typename T, typename std::enable_if<is_integer<T>::value || is_ieee754<T>::value, int>::type = 0>
+	inline R vdup_lane(neon128<T> const& a)
+	{
+		static_assert(Lane >= 0 && Lane < neon128<T>::N, "lane out of range");
+		static_assert(std::is_same<typename R::type, T>::value, "lane type mismatch");
+		return x86::store<R>(x86::broadcast<sizeof(T)>::template lane<Lane>(x86::load(a)));
+	}
+
+	// Shifts by an immediate are templates on the shift the same way, so
+	// each instance is the one psllw/psraw/psrlq-class instruction.
+#define NEON_X86_SHIFT(name, kernel, range) \
+	template <int N, typename T, typename std::enable_if<is_integer<T>::value, int>::type = 0> \
+	inline neon128<T> name(neon128<T> const& a) { static_assert(range<T>(N), "shift out of range"); return x86::store<neon128<T>>(x86::lanes<T>::template kernel<N>(x86::load(a))); } \
+	template <int N, typename T, typename std::enable_if<is_integer<T>::value, int>::type = 0> \
+	inline neon64<T> name(neon64<T> const& a) { static_assert(range<T>(N), "shift out of range"); return x86::store<neon64<T>>(x86::lanes<T>::template kernel<N>(x86::load(a))); }
+
+#define NEON_X86_SHIFT_ACCUMULATE(name, kernel, range) \
+	template <int N, typename T, typename std::enable_if<is_integer<T>::value, int>::type = 0> \
+	inline neon128<T> name(neon128<T> const& a0, neon128<T> const& a1) { static_assert(range<T>(N), "shift out of range"); return x86::store<neon128<T>>(x86::lanes<T>::template kernel<N>(x86::load(a0), x86::load(a1))); } \
+	template <int N, typename T, typename std::enable_if<is_integer<T>::value, int>::type = 0> \
+	inline neon64<T> name(neon64<T> const& a0, neon64<T> const& a1) { static_assert(range<T>(N), "shift out of range"); return x86::store<neon64<T>>(x86::lanes<T>::template kernel<N>(x86::load(a0), x86::load(a1))); }
+
+#define NEON_X86_SHIFT_NARROW(name, kernel) \
+	template <int N, typename T, typename std::enable_if<is_integer<T>::value, int>::type = 0> \
+	inline neon64<typename neon_type<T>::narrow_type> name(neon128<T> const& a) { static_assert(right_shift<typename neon_type<T>::narrow_type>(N), "shift out of range"); return x86::store<neon64<typename neon_type<T>::narrow_type>>(x86::lanes<T>::template kernel<N>(x86::load(a))); }
+
+	NEON_X86_SHIFT(vshl_n, shl, left_shift)
+	NEON_X86_SHIFT(vshr_n, shr, right_shift)
+	NEON_X86_SHIFT(vrshr_n, rshr, right_shift)
+	NEON_X86_SHIFT_ACCUMULATE(vsra_n, sra, right_shift)
+	NEON_X86_SHIFT_ACCUMULATE(vrsra_n, rsra, right_shift)
+	NEON_X86_SHIFT_ACCUMULATE(vsli_n, sli, left_shift)
+	NEON_X86_SHIFT_ACCUMULATE(vsri_n, sri, right_shift)
+	NEON_X86_SHIFT_NARROW(vshrn_n, shrn)
+	NEON_X86_SHIFT_NARROW(vrshrn_n, rshrn)
+	NEON_X86_SHIFT_NARROW(vqshrn_n, qshrn)
+	NEON_X86_SHIFT_NARROW(vqrshrn_n, qrshrn)
+
+	// vext too: one palignr for q registers.
+	template <int N, typename T, typename std::enable_if<is_integer<T>::value || is_ieee754<T>::value, int>::type = 0>
+	inline neon128<T> vext(neon128<T> const& a0, neon128<T> const& a1)
+	{
+		static_assert(N >= 0 && N < neon128<T>::N, "lane out of range");
+		return x86::store<neon128<T>>(x86::permute<sizeof(T)>::template ext<N, 16>(x86::load(a0), x86::load(a1)));
+	}
+
+	template <int N, typename T, typename std::enable_if<is_integer<T>::value || is_ieee754<T>::value, int>::type = 0>
+	inline neon64<T> vext(neon64<T> const& a0, neon64<T> const& a1)
+	{
+		static_assert(N >= 0 && N < neon64<T>::N, "lane out of range");
+		return x86::store<neon64<T>>(x86::permute<sizeof(T)>::template ext<N, 8>(x86::load(a0), x86::load(a1)));
+	}
+
+#define NEON_X86_UNARY(name, T, kernel) \
+	inline neon128<T> name(arg<neon128<T>> a) { return x86::store<neon128<T>>(x86::lanes<T>::kernel(x86::load(a))); } \
+	inline neon64<T> name(arg<neon64<T>> a) { return x86::store<neon64<T>>(x86::lanes<T>::kernel(x86::load(a))); }
+
+#define NEON_X86_BINARY(name, T, kernel) \
+	inline neon128<T> name(arg<neon128<T>> a0, arg<neon128<T>> a1) { return x86::store<neon128<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); } \
+	inline neon64<T> name(arg<neon64<T>> a0, arg<neon64<T>> a1) { return x86::store<neon64<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); }
+
+#define NEON_X86_COMPARE(name, T, kernel) \
+	inline neon128<typename cmptype<T>::type> name(arg<neon128<T>> a0, arg<neon128<T>> a1) { return x86::store<neon128<typename cmptype<T>::type>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); } \
+	inline neon64<typename cmptype<T>::type> name(arg<neon64<T>> a0, arg<neon64<T>> a1) { return x86::store<neon64<typename cmptype<T>::type>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); }
+
+#define NEON_X86_COMPARE_ZERO(name, T, kernel) \
+	inline neon128<typename cmptype<T>::type> name(arg<neon128<T>> a) { return x86::store<neon128<typename cmptype<T>::type>>(x86::lanes<T>::kernel(x86::load(a))); } \
+	inline neon64<typename cmptype<T>::type> name(arg<neon64<T>> a) { return x86::store<neon64<typename cmptype<T>::type>>(x86::lanes<T>::kernel(x86::load(a))); }
+
+#define NEON_X86_TERNARY(name, T, kernel) \
+	inline neon128<T> name(arg<neon128<T>> a0, arg<neon128<T>> a1, arg<neon128<T>> a2) { return x86::store<neon128<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1), x86::load(a2))); } \
+	inline neon64<T> name(arg<neon64<T>> a0, arg<neon64<T>> a1, arg<neon64<T>> a2) { return x86::store<neon64<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1), x86::load(a2))); }
+
+#define NEON_X86_SELECT(name, T, kernel) \
+	inline neon128<T> name(arg<neon128<typename cmptype<T>::type>> a0, arg<neon128<T>> a1, arg<neon128<T>> a2) { return x86::store<neon128<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1), x86::load(a2))); } \
+	inline neon64<T> name(arg<neon64<typename cmptype<T>::type>> a0, arg<neon64<T>> a1, arg<neon64<T>> a2) { return x86::store<neon64<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1), x86::load(a2))); }
+
+// Multiply-accumulate: op(a0, a1 * a2) with op add or sub.
+#define NEON_X86_ACCUMULATE(name, T, op) \
+	inline neon128<T> name(arg<neon128<T>> a0, arg<neon128<T>> a1, arg<neon128<T>> a2) { return x86::store<neon128<T>>(x86::lanes<T>::op(x86::load(a0), x86::lanes<T>::mul(x86::load(a1), x86::load(a2)))); } \
+	inline neon64<T> name(arg<neon64<T>> a0, arg<neon64<T>> a1, arg<neon64<T>> a2) { return x86::store<neon64<T>>(x86::lanes<T>::op(x86::load(a0), x86::lanes<T>::mul(x86::load(a1), x86::load(a2)))); }
+
+// Widening ops take the low (or, for _high, upper) half of narrow T lanes and
+// produce a full register of neon_type<T>::wide_type.
+#define NEON_X86_WIDEN(name, T, kernel) \
+	inline neon128<typename neon_type<T>::wide_type> name(arg<neon64<T>> a0, arg<neon64<T>> a1) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); } \
+	inline neon128<typename neon_type<T>::wide_type> name##_high(arg<neon128<T>> a0, arg<neon128<T>> a1) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<T>::kernel(x86::high(x86::load(a0)), x86::high(x86::load(a1)))); }
+
+#define NEON_X86_WIDEN_ACCUMULATE(name, T, op) \
+	inline neon128<typename neon_type<T>::wide_type> name(arg<neon128<typename neon_type<T>::wide_type>> a0, arg<neon64<T>> a1, arg<neon64<T>> a2) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<typename neon_type<T>::wide_type>::op(x86::load(a0), x86::lanes<T>::mull(x86::load(a1), x86::load(a2)))); } \
+	inline neon128<typename neon_type<T>::wide_type> name##_high(arg<neon128<typename neon_type<T>::wide_type>> a0, arg<neon128<T>> a1, arg<neon128<T>> a2) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<typename neon_type<T>::wide_type>::op(x86::load(a0), x86::lanes<T>::mull(x86::high(x86::load(a1)), x86::high(x86::load(a2))))); }
+
+// Absolute-difference accumulate: a0 plus kernel(a1, a2), in the lanes of a0.
+#define NEON_X86_ADD_BINARY(name, T, kernel) \
+	inline neon128<T> name(arg<neon128<T>> a0, arg<neon128<T>> a1, arg<neon128<T>> a2) { return x86::store<neon128<T>>(x86::lanes<T>::add(x86::load(a0), x86::lanes<T>::kernel(x86::load(a1), x86::load(a2)))); } \
+	inline neon64<T> name(arg<neon64<T>> a0, arg<neon64<T>> a1, arg<neon64<T>> a2) { return x86::store<neon64<T>>(x86::lanes<T>::add(x86::load(a0), x86::lanes<T>::kernel(x86::load(a1), x86::load(a2)))); }
+
+#define NEON_X86_WIDEN_ADD(name, T, kernel) \
+	inline neon128<typename neon_type<T>::wide_type> name(arg<neon128<typename neon_type<T>::wide_type>> a0, arg<neon64<T>> a1, arg<neon64<T>> a2) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<typename neon_type<T>::wide_type>::add(x86::load(a0), x86::lanes<T>::kernel(x86::load(a1), x86::load(a2)))); } \
+	inline neon128<typename neon_type<T>::wide_type> name##_high(arg<neon128<typename neon_type<T>::wide_type>> a0, arg<neon128<T>> a1, arg<neon128<T>> a2) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<typename neon_type<T>::wide_type>::add(x86::load(a0), x86::lanes<T>::kernel(x86::high(x86::load(a1)), x86::high(x86::load(a2))))); }
+
+// Width changes between integer lanes: lanes<T>::widen sign- or zero-extends
+// the low lanes of T (pmovsx/pmovzx), and the narrowing kernels run on the
+// wide lanes T and leave their result in the low half. R is the narrow lane
+// type, which for vqmovun is unsigned.
+#define NEON_X86_LONG(name, T, kernel) \
+	inline neon128<typename neon_type<T>::wide_type> name(arg<neon64<T>> a) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<T>::kernel(x86::load(a))); } \
+	inline neon128<typename neon_type<T>::wide_type> name##_high(arg<neon128<T>> a) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<T>::kernel(x86::high(x86::load(a)))); }
+
+#define NEON_X86_NARROW_TO(name, T, R, kernel) \
+	inline neon64<R> name(arg<neon128<T>> a) { return x86::store<neon64<R>>(x86::lanes<T>::kernel(x86::load(a))); } \
+	inline neon128<R> name##_high(arg<neon64<R>> a0, arg<neon128<T>> a1) { return x86::store<neon128<R>>(_mm_unpacklo_epi64(x86::load(a0), x86::lanes<T>::kernel(x86::load(a1)))); }
+
+#define NEON_X86_NARROW(name, T, kernel) \
+	NEON_X86_NARROW_TO(name, T, typename neon_type<T>::narrow_type, kernel)
+
+#define NEON_X86_NARROW_BINARY(name, T, kernel) \
+	inline neon64<typename neon_type<T>::narrow_type> name(arg<neon128<T>> a0, arg<neon128<T>> a1) { return x86::store<neon64<typename neon_type<T>::narrow_type>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); } \
+	inline neon128<typename neon_type<T>::narrow_type> name##_high(arg<neon64<typename neon_type<T>::narrow_type>> a0, arg<neon128<T>> a1, arg<neon128<T>> a2) { return x86::store<neon128<typename neon_type<T>::narrow_type>>(_mm_unpacklo_epi64(x86::load(a0), x86::lanes<T>::kernel(x86::load(a1), x86::load(a2)))); }
+
+// Across-lanes reductions; the kernel leaves the result in lane 0.
+#define NEON_X86_REDUCE(name, T, kernel) \
+	inline T name(arg<neon128<T>> a) { return x86::first<T>(x86::lanes<T>::template kernel<neon128<T>::N>(x86::load_dup(a))); } \
+	inline T name(arg<neon64<T>> a) { return x86::first<T>(x86::lanes<T>::template kernel<neon64<T>::N>(x86::load_dup(a))); }
+
+#define NEON_X86_REDUCE_LONG(name, T, kernel) \
+	inline typename neon_type<T>::wide_type name(arg<neon128<T>> a) { return x86::first<typename neon_type<T>::wide_type>(x86::lanes<T>::template kernel<neon128<T>::N>(x86::load_dup(a))); } \
+	inline typename neon_type<T>::wide_type name(arg<neon64<T>> a) { return x86::first<typename neon_type<T>::wide_type>(x86::lanes<T>::template kernel<neon64<T>::N>(x86::load_dup(a))); }
+
+// Pairwise ops: the q kernel pairs up a0 into the low half and a1 into the
+// high half, so the d form runs it on both operands packed into one register.
+#define NEON_X86_PAIRWISE_Q(name, T, kernel) \
+	inline neon128<T> name(arg<neon128<T>> a0, arg<neon128<T>> a1) { return x86::store<neon128<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); }
+
+#define NEON_X86_PAIRWISE(name, T, kernel) \
+	NEON_X86_PAIRWISE_Q(name, T, kernel) \
+	inline neon64<T> name(arg<neon64<T>> a0, arg<neon64<T>> a1) { __m128i c = _mm_unpacklo_epi64(x86::load(a0), x86::load(a1)); return x86::store<neon64<T>>(x86::lanes<T>::kernel(c, c)); }
+
+#define NEON_X86_PAIRWISE_LONG(name, T, kernel) \
+	inline neon128<typename neon_type<T>::wide_type> name(arg<neon128<T>> a) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<T>::kernel(x86::load(a))); } \
+	inline neon64<typename neon_type<T>::wide_type> name(arg<neon64<T>> a) { return x86::store<neon64<typename neon_type<T>::wide_type>>(x86::lanes<T>::kernel(x86::load(a))); }
+
+#define NEON_X86_PAIRWISE_ACCUMULATE(name, T, kernel) \
+	inline neon128<typename neon_type<T>::wide_type> name(arg<neon128<typename neon_type<T>::wide_type>> a0, arg<neon128<T>> a1) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<typename neon_type<T>::wide_type>::add(x86::load(a0), x86::lanes<T>::kernel(x86::load(a1)))); } \
+	inline neon64<typename neon_type<T>::wide_type> name(arg<neon64<typename neon_type<T>::wide_type>> a0, arg<neon64<T>> a1) { return x86::store<neon64<typename neon_type<T>::wide_type>>(x86::lanes<typename neon_type<T>::wide_type>::add(x86::load(a0), x86::lanes<T>::kernel(x86::load(a1)))); }
+
+// Shifts by a register of signed per-lane counts.
+#define NEON_X86_SHIFT_BY(name, T, kernel) \
+	inline neon128<T> name(arg<neon128<T>> a0, arg<neon128<typename std::make_signed<T>::type>> a1) { return x86::store<neon128<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); } \
+	inline neon64<T> name(arg<neon64<T>> a0, arg<neon64<typename std::make_signed<T>::type>> a1) { return x86::store<neon64<T>>(x86::lanes<T>::kernel(x86::load(a0), x86::load(a1))); }
+
+// Permutations only move lanes, so they are instantiated for every lane type.
+// A pair is the A64 forms name1 and name2 plus the ARMv7 name returning both.
+#define NEON_X86_PERMUTE(name, T, kernel) \
+	inline neon128<T> name(arg<neon128<T>> a0, arg<neon128<T>> a1) { return x86::store<neon128<T>>(x86::permute<sizeof(T)>::template kernel<16>(x86::load(a0), x86::load(a1))); } \
+	inline neon64<T> name(arg<neon64<T>> a0, arg<neon64<T>> a1) { return x86::store<neon64<T>>(x86::permute<sizeof(T)>::template kernel<8>(x86::load(a0), x86::load(a1))); }
+
+#define NEON_X86_PERMUTE_PAIR(name, T, kernel) \
+	NEON_X86_PERMUTE(name##1, T, kernel##1) \
+	NEON_X86_PERMUTE(name##2, T, kernel##2) \
+	inline neon_tuple<neon128<T>, 2> name(arg<neon128<T>> a0, arg<neon128<T>> a1) { __m128i a = x86::load(a0), b = x86::load(a1); return { { x86::store<neon128<T>>(x86::permute<sizeof(T)>::template kernel##1<16>(a, b)), x86::store<neon128<T>>(x86::permute<sizeof(T)>::template kernel##2<16>(a, b)) } }; } \
+	inline neon_tuple<neon64<T>, 2> name(arg<neon64<T>> a0, arg<neon64<T>> a1) { __m128i a = x86::load(a0), b = x86::load(a1); return { { x86::store<neon64<T>>(x86::permute<sizeof(T)>::template kernel##1<8>(a, b)), x86::store<neon64<T>>(x86::permute<sizeof(T)>::template kernel##2<8>(a, b)) } }; }
+
+#define NEON_X86_REVERSE(name, T, bits) \
+	inline neon128<T> name(arg<neon128<T>> a) { return x86::store<neon128<T>>(x86::permute<sizeof(T)>::template rev<bits / 8>(x86::load(a))); } \
+	inline neon64<T> name(arg<neon64<T>> a) { return x86::store<neon64<T>>(x86::permute<sizeof(T)>::template rev<bits / 8>(x86::load(a))); }
+
+// Float width changes; lanes<T>::cvtl widens the low lanes of T and
+// lanes<T>::cvtn narrows a register of the wide type.
+#define NEON_X86_CONVERT(T) \
+	inline neon128<typename neon_type<T>::wide_type> vcvt_long(arg<neon64<T>> a) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<T>::cvtl(x86::load(a))); } \
+	inline neon128<typename neon_type<T>::wide_type> vcvt_long_high(arg<neon128<T>> a) { return x86::store<neon128<typename neon_type<T>::wide_type>>(x86::lanes<T>::cvtl(x86::high(x86::load(a)))); } \
+	inline neon64<T> vcvt_narrow(arg<neon128<typename neon_type<T>::wide_type>> a) { return x86::store<neon64<T>>(x86::lanes<T>::cvtn(x86::load(a))); } \
+	inline neon128<T> vcvt_narrow_high(arg<neon64<T>> a0, arg<neon128<typename neon_type<T>::wide_type>> a1) { return x86::store<neon128<T>>(_mm_unpacklo_epi64(x86::load(a0), x86::lanes<T>::cvtn(x86::load(a1)))); }
+
+// Explicit specializations have to live in neon:: itself, so a backend
+// namespace of the runtime dispatch gets a forwarding vldn template and plain
+// vstn overloads instead; both are found ahead of the neon:: templates.
+#undef NEON_X86_STRUCTURE
+#if defined(NEON_X86_NAMESPACE)
+	template <typename V, size_t Count>
+	inline neon_tuple<V, Count> vldn(typename V::type const* p) { return x86::ldn<V, Count>(p); }
+
+#define NEON_X86_STRUCTURE(V, Count) \
+	inline void vstn(V::type* p, neon_tuple<V, Count> const& a) { x86::stn<V, Count>(p, a); }
+#else
+#define NEON_X86_STRUCTURE(V, Count) \
+	template <> inline neon_tuple<V, Count> vldn<V, Count>(V::type const* p) { return x86::ldn<V, Count>(p); } \
+	template <> inline void vstn<V, Count>(V::type* p, neon_tuple<V, Count> const& a) { x86::stn<V, Count>(p, a); }
+#endif
+
+#define NEON_X86_STRUCTURES(T) \
+	NEON_X86_STRUCTURE(neon64<T>, 2) NEON_X86_STRUCTURE(neon64<T>, 3) NEON_X86_STRUCTURE(neon64<T>, 4) \
+	NEON_X86_STRUCTURE(neon128<T>, 2) NEON_X86_STRUCTURE(neon128<T>, 3) NEON_X86_STRUCTURE(neon128<T>, 4)
+
+// vtbl/vtbx for one table shape; I is the index (and result) register width.
+#define NEON_X86_LOOKUP(T, V, Count, I, U) \
+	inline I<T> vtbl(neon_tuple<V<T>, Count> const& a0, arg<I<U>> a1) { return x86::tbl<I<T>>(a0, x86::load(a1)); } \
+	inline I<T> vtbx(arg<I<T>> a0, neon_tuple<V<T>, Count> const& a1, arg<I<U>> a2) { return x86::tbx<I<T>>(x86::load(a0), a1, x86::load(a2)); }
+
+#define NEON_X86_LOOKUPS(T) \
+	NEON_X86_LOOKUP(T, neon64, 1, neon64, T) NEON_X86_LOOKUP(T, neon64, 2, neon64, T) \
+	NEON_X86_LOOKUP(T, neon64, 3, neon64, T) NEON_X86_LOOKUP(T, neon64, 4, neon64, T) \
+	NEON_X86_LOOKUP(T, neon128, 1, neon64, uint8_t) NEON_X86_LOOKUP(T, neon128, 2, neon64, uint8_t) \
+	NEON_X86_LOOKUP(T, neon128, 3, neon64, uint8_t) NEON_X86_LOOKUP(T, neon128, 4, neon64, uint8_t) \
+	NEON_X86_LOOKUP(T, neon128, 1, neon128, uint8_t) NEON_X86_LOOKUP(T, neon128, 2, neon128, uint8_t) \
+	NEON_X86_LOOKUP(T, neon128, 3, neon128, uint8_t) NEON_X86_LOOKUP(T, neon128, 4, neon128, uint8_t)
+
+#define NEON_X86_FOR_INTEGER_TYPES(M, name, kernel) \
+	M(name, int8_t, kernel) M(name, int16_t, kernel) M(name, int32_t, kernel) M(name, int64_t, kernel) \
+	M(name, uint8_t, kernel) M(name, uint16_t, kernel) M(name, uint32_t, kernel) M(name, uint64_t, kernel)
+
+#define NEON_X86_FOR_SIGNED_TYPES(M, name, kernel) \
+	M(name, int8_t, kernel) M(name, int16_t, kernel) M(name, int32_t, kernel) M(name, int64_t, kernel)
+
+#define NEON_X86_FOR_MULTIPLY_TYPES(M, name, kernel) \
+	M(name, int8_t, kernel) M(name, int16_t, kernel) M(name, int32_t, kernel) \
+	M(name, uint8_t, kernel) M(name, uint16_t, kernel) M(name, uint32_t, kernel)
+
+#define NEON_X86_FOR_NARROWING_TYPES(M, name, kernel) \
+	M(name, int16_t, kernel) M(name, int32_t, kernel) M(name, int64_t, kernel) \
+	M(name, uint16_t, kernel) M(name, uint32_t, kernel) M(name, uint64_t, kernel)
+
+#define NEON_X86_FOR_FLOAT_TYPES(M, name, kernel) \
+	M(name, float32_t, kernel) M(name, float64_t, kernel)
+
+#define NEON_X86_FOR_ALL_TYPES(M, name, kernel) \
+	NEON_X86_FOR_INTEGER_TYPES(M, name, kernel) M(name, float16_t, kernel) NEON_X86_FOR_FLOAT_TYPES(M, name, kernel)
+
+#undef NEON_X86_FOR_HALF_TYPES
+#if defined(NEON_X86_F16C)
+#define NEON_X86_FOR_HALF_TYPES(M, name, kernel) \
+	M(name, float16_t, kernel)
+#else
+#define NEON_X86_FOR_HALF_TYPES(M, name, kernel)
+#endif
+
+// Register-count shifts, from AVX2's variable shifts.
+#undef NEON_X86_FOR_VARIABLE_SHIFT_TYPES
+#if NEON_X86_LEVEL >= NEON_BACKEND_AVX2
+#define NEON_X86_FOR_VARIABLE_SHIFT_TYPES(M, name, kernel) NEON_X86_FOR_INTEGER_TYPES(M, name, kernel)
+#else
+#define NEON_X86_FOR_VARIABLE_SHIFT_TYPES(M, name, kernel)
+#endif
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, vabd, abd)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_BINARY, vabd, abd)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_BINARY, vabd, abd)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_ADD_BINARY, vaba, abd)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_WIDEN_ADD, vabal, abdl)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_WIDEN, vabdl, abdl)
+
+	NEON_X86_FOR_SIGNED_TYPES(NEON_X86_UNARY, vabs, abs)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_UNARY, vabs, abs)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_UNARY, vabs, abs)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, vadd, add)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_BINARY, vadd, add)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_BINARY, vadd, add)
+	NEON_X86_FOR_NARROWING_TYPES(NEON_X86_NARROW_BINARY, vaddhn, addhn)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_REDUCE, vaddv, addv)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_REDUCE, vaddv, addv)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_REDUCE_LONG, vaddlv, addlv)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, vand, band)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, vbic, bic)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_SELECT, vbsl, bsl)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_SELECT, vbsl, bsl)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_SELECT, vbsl, bsl)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_TERNARY, vbcax, bcax)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE, vceq, ceq)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vceq, ceq)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vceq, ceq)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE_ZERO, vceqz, ceqz)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE_ZERO, vceqz, ceqz)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE_ZERO, vceqz, ceqz)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE, vcge, cge)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vcge, cge)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vcge, cge)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE_ZERO, vcgez, cgez)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE_ZERO, vcgez, cgez)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE_ZERO, vcgez, cgez)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE, vcle, cle)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vcle, cle)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vcle, cle)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE_ZERO, vclez, clez)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE_ZERO, vclez, clez)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE_ZERO, vclez, clez)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE, vcgt, cgt)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vcgt, cgt)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vcgt, cgt)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE_ZERO, vcgtz, cgtz)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE_ZERO, vcgtz, cgtz)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE_ZERO, vcgtz, cgtz)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE, vclt, clt)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vclt, clt)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vclt, clt)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_COMPARE_ZERO, vcltz, cltz)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE_ZERO, vcltz, cltz)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE_ZERO, vcltz, cltz)
+
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vcage, cage)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vcage, cage)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vcale, cale)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vcale, cale)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vcagt, cagt)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vcagt, cagt)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_COMPARE, vcalt, calt)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_COMPARE, vcalt, calt)
+
+	NEON_X86_CONVERT(float32_t)
+#if defined(NEON_X86_F16C)
+	NEON_X86_CONVERT(float16_t)
+#endif
+
+	NEON_X86_FOR_SIGNED_TYPES(NEON_X86_UNARY, vqabs, qabs)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, vqadd, qadd)
+	NEON_X86_BINARY(vqdmulh, int16_t, qdmulh)
+	NEON_X86_BINARY(vqdmulh, int32_t, qdmulh)
+	NEON_X86_FOR_NARROWING_TYPES(NEON_X86_NARROW, vqmovn, qnarrow)
+	NEON_X86_NARROW_TO(vqmovun, int16_t, uint8_t, qnarrowu)
+	NEON_X86_NARROW_TO(vqmovun, int32_t, uint16_t, qnarrowu)
+	NEON_X86_NARROW_TO(vqmovun, int64_t, uint32_t, qnarrowu)
+	NEON_X86_FOR_SIGNED_TYPES(NEON_X86_UNARY, vqneg, qneg)
+	NEON_X86_BINARY(vqrdmulh, int16_t, qrdmulh)
+	NEON_X86_BINARY(vqrdmulh, int32_t, qrdmulh)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, vqsub, qsub)
+	NEON_X86_FOR_VARIABLE_SHIFT_TYPES(NEON_X86_SHIFT_BY, vqshl, qshl_by)
+	NEON_X86_FOR_VARIABLE_SHIFT_TYPES(NEON_X86_SHIFT_BY, vrshl, rshl_by)
+	NEON_X86_FOR_VARIABLE_SHIFT_TYPES(NEON_X86_SHIFT_BY, vshl, shl_by)
+
+	NEON_X86_STRUCTURES(int8_t) NEON_X86_STRUCTURES(int16_t) NEON_X86_STRUCTURES(int32_t) NEON_X86_STRUCTURES(int64_t)
+	NEON_X86_STRUCTURES(uint8_t) NEON_X86_STRUCTURES(uint16_t) NEON_X86_STRUCTURES(uint32_t) NEON_X86_STRUCTURES(uint64_t)
+	NEON_X86_STRUCTURES(float16_t) NEON_X86_STRUCTURES(float32_t) NEON_X86_STRUCTURES(float64_t)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, veor, beor)
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_TERNARY, veor3, eor3)
+
+#if defined(NEON_X86_FMA)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_TERNARY, vfma, fma)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_TERNARY, vfms, fms)
+#endif
+
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_BINARY, vhadd, hadd)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_BINARY, vhsub, hsub)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_BINARY, vrhadd, rhadd)
+
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_REDUCE, vmaxv, maxv)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_REDUCE, vmaxv, maxv)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_REDUCE, vmaxv, maxv)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_REDUCE, vmaxnmv, maxnmv)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_REDUCE, vmaxnmv, maxnmv)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_REDUCE, vminv, minv)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_REDUCE, vminv, minv)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_REDUCE, vminv, minv)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_REDUCE, vminnmv, minnmv)
+	NEON_X86_FOR_HALF_TYPES(NEON_X86_REDUCE, vminnmv, minnmv)
+
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_ACCUMULATE, vmla, add)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_ACCUMULATE, vmla, add)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_WIDEN_ACCUMULATE, vmlal, add)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_ACCUMULATE, vmls, sub)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_ACCUMULATE, vmls, sub)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_WIDEN_ACCUMULATE, vmlsl, sub)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_BINARY, vmul, mul)
+	NEON_X86_FOR_FLOAT_TYPES(NEON_X86_BINARY, vmul, mul)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_WIDEN, vmull, mull)
+
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_LONG, vmovl, widen)
+	NEON_X86_FOR_NARROWING_TYPES(NEON_X86_NARROW, vmovn, narrow)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_UNARY, vmvn, mvn)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, vorn, orn)
+
+	NEON_X86_FOR_INTEGER_TYPES(NEON_X86_BINARY, vorr, borr)
+
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_PAIRWISE, vpadd, padd)
+	NEON_X86_PAIRWISE(vpadd, float32_t, padd)
+	NEON_X86_PAIRWISE_Q(vpadd, int64_t, padd)
+	NEON_X86_PAIRWISE_Q(vpadd, uint64_t, padd)
+	NEON_X86_PAIRWISE_Q(vpadd, float64_t, padd)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_PAIRWISE_LONG, vpaddl, paddl)
+	NEON_X86_FOR_MULTIPLY_TYPES(NEON_X86_PAIRWISE_ACCUMULATE, vpadal, paddl)
+
+	NEON_X86_REVERSE(vrev16, int8_t, 16) NEON_X86_REVERSE(vrev16, uint8_t, 16)
+	NEON_X86_REVERSE(vrev32, int8_t, 32) NEON_X86_REVERSE(vrev32, uint8_t, 32)
+	NEON_X86_REVERSE(vrev32, int16_t, 32) NEON_X86_REVERSE(vrev32, uint16_t, 32)
+	NEON_X86_REVERSE(vrev64, int8_t, 64) NEON_X86_REVERSE(vrev64, uint8_t, 64)
+	NEON_X86_REVERSE(vrev64, int16_t, 64) NEON_X86_REVERSE(vrev64, uint16_t, 64) NEON_X86_REVERSE(vrev64, float16_t, 64)
+	NEON_X86_REVERSE(vrev64, int32_t, 64) NEON_X86_REVERSE(vrev64, uint32_t, 64) NEON_X86_REVERSE(vrev64, float32_t, 64)
+
+	NEON_X86_LOOKUPS(int8_t) NEON_X86_LOOKUPS(uint8_t)
+
+	NEON_X86_FOR_ALL_TYPES(NEON_X86_PERMUTE_PAIR, vtrn, trn)
+	NEON_X86_FOR_ALL_TYPES(NEON_X86_PERMUTE_PAIR, vuzp, uzp)
+	NEON_X86_FOR_ALL_TYPES(NEON_X86_PERMUTE_PAIR, vzip, zip)
+
+#if defined(NEON_X86_NAMESPACE)
+} // namespace NEON_X86_NAMESPACE
+#endif
+} // namespace neon
+
+#endif
+
+#undef NEON_X86_LEVEL
@@ -0,0 +1,404 @@
+// Replays traces recorded with NEON_TRACE (see neon_trace.h) on the backends
+// of the runtime-dispatched api, and reports the first call whose result
+// differs from the recorded one.
+//
+//   python3 api.py --dispatch > neon_api.h
+//   g++ -std=c++14 -O2 -I. replay.cpp -o replay
+//   ./replay [--backend avx2] [--exact-nan] neon.1234.0.trace ...
+//
+// Record on aarch64 with the native intrinsics to compare the emulation with
+// the hardware, or on x86 to replay a run on the other backends. The traced
+// build and the replay must be generated by the same api.py, which the api
+// hash in the trace header checks. --backend may be repeated; without it
+// every backend the host runs is replayed. Loads are fed the memory they
+// read and stores are compared through the memory they wrote; the lane and
+// immediate forms run with their recorded constant. NaN lanes match any NaN
+// unless --exact-nan. The exit code is 1 when a call diverges.
+
+#include "neon_api.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace replay {
+
+	struct options
+	{
+		std::vector<int> backends;
+		bool exact_nan = false;
+	};
+
+	static options o;
+
+	template <size_t Bytes> struct uint_of;
+	template <> struct uint_of<1> { using type = uint8_t; };
+	template <> struct uint_of<2> { using type = uint16_t; };
+	template <> struct uint_of<4> { using type = uint32_t; };
+	template <> struct uint_of<8> { using type = uint64_t; };
+
+	// Memory behind pointer arguments: the recorded bytes for loads, zeroes
+	// for stores to write into.
+	struct scratch
+	{
+		alignas(64) unsigned char in[64];
+		alignas(64) unsigned char out[64];
+	};
+
+	template <typename T>
+	void read(T& v, unsigned char const* payload, size_t& at, size_t, scratch&)
+	{
+		std::memcpy(&v, payload + at, sizeof(T));
+		at += 16 * neon::trace::slots(sizeof(T));
+	}
+
+	template <typename T>
+	void read(T const*& p, unsigned char const* payload, size_t& at, size_t memory, scratch& s)
+	{
+		std::memcpy(s.in, payload + at, memory);
+		at += 16 * neon::trace::slots(memory);
+		p = reinterpret_cast<T const*>(s.in);
+	}
+
+	// Stores come last in the record, as their result.
+	template <typename T>
+	void read(T*& p, unsigned char const*, size_t&, size_t, scratch& s)
+	{
+		std::memset(s.out, 0, sizeof(s.out));
+		p = reinterpret_cast<T*>(s.out);
+	}
+
+	template <typename T>
+	bool same_lane(T a, T b)
+	{
+		if (neon::is_ieee754<T>::value && !o.exact_nan && a != a && b != b)
+			return true;
+		return std::memcmp(&a, &b, sizeof(T)) == 0;
+	}
+
+	// Index of the first differing lane, or -1.
+	template <typename T>
+	int first_diff(T const& a, T const& b)
+	{
+		return same_lane(a, b) ? -1 : 0;
+	}
+
+	template <typename V>
+	int first_diff_lanes(V const& a, V const& b)
+	{
+		for (int i = 0; i < int(V::N); i++)
+			if (!same_lane(a[i], b[i]))
+				return i;
+		return -1;
+	}
+
+	template <typename T>
+	int first_diff(neon::neon64<T> const& a, neon::neon64<T> const& b)
+	{
+		return first_diff_lanes(a, b);
+	}
+
+	template <typename T>
+	int first_diff(neon::neon128<T> const& a, neon::neon128<T> const& b)
+	{
+		return first_diff_lanes(a, b);
+	}
+
+	template <typename V, size_t Count>
+	int first_diff(neon::neon_tuple<V, Count> const& a, neon::neon_tuple<V, Count> const& b)
+	{
+		for (size_t r = 0; r < Count; r++)
+		{
+			int i = first_diff(a.val[r], b.val[r]);
+			if (i >= 0)
+				return int(r * V::N) + i;
+		}
+		return -1;
+	}
+
+	template <typename T>
+	std::string hex(T v)
+	{
+		typename uint_of<sizeof(T)>::type raw;
+		std::memcpy(&raw, &v, sizeof(T));
+		char s[24];
+		std::snprintf(s, sizeof(s), "0x%0*llx", int(2 * sizeof(T)), (unsigned long long)raw);
+		return s;
+	}
+
+	inline std::string bytes(unsigned char const* p, size_t n)
+	{
+		std::string s = "&{";
+		for (size_t i = 0; i < n; i++)
+		{
+			char b[8];
+			std::snprintf(b, sizeof(b), "%s%02x", i ? " " : "", p[i]);
+			s += b;
+		}
+		return s + "}";
+	}
+
+	template <typename T>
+	std::string describe(T const& v, size_t)
+	{
+		return hex(v);
+	}
+
+	template <typename V>
+	std::string describe_lanes(V const& v)
+	{
+		std::string s = "{";
+		for (size_t i = 0; i < V::N; i++)
+			s += (i ? ", " : "") + hex(v[int(i)]);
+		return s + "}";
+	}
+
+	template <typename T>
+	std::string describe(neon::neon64<T> const& v, size_t)
+	{
+		return describe_lanes(v);
+	}
+
+	template <typename T>
+	std::string describe(neon::neon128<T> const& v, size_t)
+	{
+		return describe_lanes(v);
+	}
+
+	template <typename V, size_t Count>
+	std::string describe(neon::neon_tuple<V, Count> const& v, size_t memory)
+	{
+		std::string s = "[";
+		for (size_t r = 0; r < Count; r++)
+			s += (r ? ", " : "") + describe(v.val[r], memory);
+		return s + "]";
+	}
+
+	template <typename T>
+	std::string describe(T* const& p, size_t memory)
+	{
+		return std::is_const<T>::value ? bytes(reinterpret_cast<unsigned char const*>(p), memory) : "&out";
+	}
+
+	template <typename Inputs, size_t... I>
+	void read_inputs(Inputs& in, unsigned char const* payload, size_t& at, size_t memory, scratch& s, std::index_sequence<I...>)
+	{
+		int unused[] = { (read(std::get<I>(in), payload, at, memory, s), 0)..., 0 };
+		(void)unused;
+	}
+
+	template <typename Inputs, size_t... I>
+	std::string describe_inputs(Inputs const& in, size_t memory, std::index_sequence<I...>)
+	{
+		std::string s;
+		int unused[] = { (s += "  a" + std::to_string(I) + " = " + describe(std::get<I>(in), memory) + "\n", 0)..., 0 };
+		(void)unused;
+		return s;
+	}
+
+	template <typename R, typename... A, typename Inputs, size_t... I>
+	typename std::enable_if<!std::is_void<R>::value, std::string>::type
+		compare(R (*f)(A...), Inputs& in, unsigned char const* recorded, size_t memory, scratch&, std::index_sequence<I...> indexes)
+	{
+		R expected;
+		std::memcpy(&expected, recorded, sizeof(R));
+		R got = f(std::get<I>(in)...);
+		int lane = first_diff(expected, got);
+		if (lane < 0)
+			return std::string();
+		return "lane " + std::to_string(lane) + " differs\n" + describe_inputs(in, memory, indexes) +
+			"  recorded " + describe(expected, memory) + "\n  got      " + describe(got, memory) + "\n";
+	}
+
+	template <typename R, typename... A, typename Inputs, size_t... I>
+	typename std::enable_if<std::is_void<R>::value, std::string>::type
+		compare(R (*f)(A...), Inputs& in, unsigned char const* recorded, size_t memory, scratch& s, std::index_sequence<I...> indexes)
+	{
+		f(std::get<I>(in)...);
+		if (std::memcmp(recorded, s.out, memory) == 0)
+			return std::string();
+		size_t at = 0;
+		while (recorded[at] == s.out[at])
+			at++;
+		return "stored byte " + std::to_string(at) + " differs\n" + describe_inputs(in, memory, indexes) +
+			"  recorded " + bytes(recorded, memory) + "\n  got      " + bytes(s.out, memory) + "\n";
+	}
+
+	// Replays one call on a backend: empty when it matches the trace, the
+	// report otherwise.
+	template <typename R, typename... A>
+	std::string run(int backend, unsigned char const* payload, size_t memory,
+		R (*scalar)(A...), R (*sse42)(A...), R (*avx2)(A...), R (*avx512)(A...))
+	{
+		using indexes = std::index_sequence_for<A...>;
+		R (*const backends[])(A...) = { scalar, sse42, avx2, avx512 };
+		std::tuple<typename std::decay<A>::type...> in;
+		scratch s;
+		size_t at = 0;
+		read_inputs(in, payload, at, memory, s, indexes());
+		return compare(backends[backend], in, payload + at, memory, s, indexes());
+	}
+
+	// Replays a lane or immediate form with the constant of the call. pick
+	// maps std::integral_constant<int, C> to the form's C instantiation on
+	// each backend, a tuple of four function pointers.
+	template <int Lo, typename Pick, size_t... I>
+	std::string run_constant(int backend, unsigned char const* payload, size_t memory, int constant, Pick pick, std::index_sequence<I...>)
+	{
+		using backends = decltype(pick(std::integral_constant<int, Lo>()));
+		static const backends table[] = { pick(std::integral_constant<int, Lo + int(I)>())... };
+		if (constant < Lo || constant >= Lo + int(sizeof...(I)))
+			return "constant " + std::to_string(constant) + " is out of range\n";
+		backends const& f = table[constant - Lo];
+		return run(backend, payload, memory, std::get<0>(f), std::get<1>(f), std::get<2>(f), std::get<3>(f));
+	}
+
+	struct entry
+	{
+		const char* name;
+		bool constant; // a lane or immediate form
+		std::string (*run)(int backend, unsigned char const* payload, size_t memory, int constant);
+	};
+
+} // namespace replay
+
+#define NEON_REPLAY_FUNCTION(name) \
+	{ #name, false, [](int backend, unsigned char const* payload, size_t memory, int) { \
+		return replay::run(backend, payload, memory, &neon::scalar::name, &neon::sse42::name, &neon::avx2::name, &neon::avx512::name); \
+	} },
+
+#define NEON_REPLAY_IMMEDIATE(name, lo, hi) \
+	{ #name, true, [](int backend, unsigned char const* payload, size_t memory, int constant) { \
+		return replay::run_constant<lo>(backend, payload, memory, constant, [](auto c) { \
+			return std::make_tuple(&neon::scalar::name<decltype(c)::value>, &neon::sse42::name<decltype(c)::value>, \
+				&neon::avx2::name<decltype(c)::value>, &neon::avx512::name<decltype(c)::value>); \
+		}, std::make_index_sequence<hi - lo + 1>()); \
+	} },
+
+// in function id order
+static const replay::entry entries[] = {
+	NEON_API_FUNCTIONS(NEON_REPLAY_FUNCTION)
+	NEON_API_IMMEDIATE_RANGES(NEON_REPLAY_IMMEDIATE)
+};
+
+// Replays a trace file on a backend; false on divergence or a bad file.
+static bool replay_file(const char* path, std::vector<unsigned char> const& file, int backend)
+{
+	using neon::trace::header;
+	using neon::trace::record;
+
+	auto const& h = *reinterpret_cast<header const*>(file.data());
+	auto const* records = reinterpret_cast<record const*>(file.data() + sizeof(header));
+	const size_t count = sizeof(entries) / sizeof(entries[0]);
+
+	uint64_t calls = 0;
+	uint64_t i = h.head > h.capacity ? h.head - h.capacity : 0;
+	while (i < h.head)
+	{
+		record const& r = records[i % h.capacity];
+		// the oldest records may continue a call that was overwritten
+		if (!r.records)
+		{
+			i++;
+			continue;
+		}
+		if (r.id >= count || i + r.records > h.head)
+		{
+			std::printf("%s: record %llu is corrupt\n", path, (unsigned long long)i);
+			return false;
+		}
+
+		unsigned char payload[255 * sizeof(r.slot)];
+		for (uint64_t k = 0; k < r.records; k++)
+			std::memcpy(payload + k * sizeof(r.slot), records[(i + k) % h.capacity].slot, sizeof(r.slot));
+
+		replay::entry const& e = entries[r.id];
+		std::string report = e.run(backend, payload, r.memory, r.constant);
+		if (!report.empty())
+		{
+			std::string name = e.name;
+			if (e.constant)
+				name += "<" + std::to_string(r.constant) + ">";
+			std::printf("%s: call %llu, %s on %s: %s", path, (unsigned long long)r.seq, name.c_str(),
+				neon::dispatch::backend_name(backend), report.c_str());
+			return false;
+		}
+		calls++;
+		i += r.records;
+	}
+
+	std::printf("%s: %llu calls match on %s\n", path, (unsigned long long)calls, neon::dispatch::backend_name(backend));
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	auto& o = replay::o;
+	std::vector<const char*> paths;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string flag = argv[i];
+		if (flag == "--exact-nan") o.exact_nan = true;
+		else if (flag == "--backend" && i + 1 < argc)
+		{
+			int b = neon::dispatch::parse_backend(argv[++i]);
+			if (b < 0 || b > neon::dispatch::detect())
+			{
+				std::fprintf(stderr, "backend %s is unknown or not supported by this host\n", argv[i]);
+				return 2;
+			}
+			o.backends.push_back(b);
+		}
+		else if (flag.compare(0, 2, "--") != 0) paths.push_back(argv[i]);
+		else
+		{
+			std::fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+	if (paths.empty())
+	{
+		std::fprintf(stderr, "usage: replay [--backend name] [--exact-nan] trace...\n");
+		return 2;
+	}
+	if (o.backends.empty())
+		for (int b = NEON_BACKEND_SCALAR; b <= neon::dispatch::backend(); b++)
+			o.backends.push_back(b);
+
+	bool diverged = false;
+	for (const char* path : paths)
+	{
+		std::vector<unsigned char> file;
+		if (FILE* f = std::fopen(path, "rb"))
+		{
+			unsigned char buffer[1 << 16];
+			size_t n;
+			while ((n = std::fread(buffer, 1, sizeof(buffer), f)) > 0)
+				file.insert(file.end(), buffer, buffer + n);
+			std::fclose(f);
+		}
+
+		auto const* h = reinterpret_cast<neon::trace::header const*>(file.data());
+		const char* error = nullptr;
+		if (file.size() < sizeof(neon::trace::header) || h->magic != NEON_TRACE_MAGIC)
+			error = "not a trace";
+		else if (h->api != NEON_API_HASH)
+			error = "recorded with a different api.py";
+		else if (h->record_size != sizeof(neon::trace::record) || !h->capacity ||
+			file.size() < sizeof(neon::trace::header) + h->capacity * sizeof(neon::trace::record))
+			error = "truncated or of another version";
+		if (error)
+		{
+			std::printf("%s: %s\n", path, error);
+			diverged = true;
+			continue;
+		}
+
+		for (int b : o.backends)
+			diverged = !replay_file(path, file, b) || diverged;
+	}
+	return diverged ? 1 : 0;
+}
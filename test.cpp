@@ -36,6 +36,21 @@ int main()
 	_Float16 a(3.0);
 	if (float(a) != 3.0f) __debugbreak();
 
+#if defined(NEON_RUNTIME_DISPATCH)
+	// runtime dispatch
+	{
+		if (neon::dispatch::parse_backend("avx2") != NEON_BACKEND_AVX2 || neon::dispatch::parse_backend("AVX2") != -1 || neon::dispatch::parse_backend(nullptr) != -1)
+		{
+			__debugbreak();
+		}
+
+		if (neon::dispatch::backend() > neon::dispatch::detect())
+		{
+			__debugbreak();
+		}
+	}
+#endif
+
 
 	// vabd
 	{
@@ -88,6 +103,74 @@ int main()
 			__debugbreak();
 		}
 	}
+	{
+		uint8x16_t v0{ 200, 0, 255, 1, 128, 127, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 };
+		uint8x16_t v1{ 10, 255, 0, 1, 127, 128, 6, 5, 7, 8, 9, 10, 11, 12, 13, 14 };
+		uint8x16_t r = vabdq_u8(v0, v1);
+
+		if (r != uint8x16_t{ 190, 255, 255, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vaba, vabal, vabdl
+	{
+		int8x8_t v0{ -128, 127, 0, -1, 5, 6, 7, 8 };
+		int8x8_t v1{ 127, -128, 0, 1, 6, 5, 7, 8 };
+		int8x8_t acc{ 1, 1, 1, 1, 1, 1, 1, 1 };
+
+		if (vabdl_s8(v0, v1) != int16x8_t{ 255, 255, 0, 2, 1, 1, 0, 0 } || vaba_s8(acc, v0, v1) != int8x8_t{ 0, 0, 1, 3, 2, 2, 1, 1 })
+		{
+			__debugbreak();
+		}
+
+		if (vabal_s8(int16x8_t{ -300, 0, 0, 0, 0, 0, 0, 32767 }, v0, v1) != int16x8_t{ -45, 255, 0, 2, 1, 1, 0, 32767 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		uint8x16_t v0{ 200, 0, 255, 1, 128, 127, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 };
+		uint8x16_t v1{ 10, 255, 0, 1, 127, 128, 6, 5, 7, 8, 9, 10, 11, 12, 13, 114 };
+
+		uint16x8_t sad = vabdl_u8(vget_low_u8(v0), vget_low_u8(v1));
+		sad = vabal_high_u8(sad, v0, v1);
+		if (vaddvq_u16(sad) != 804 || vaddlvq_u8(vabdq_u8(v0, v1)) != 804 || vabdl_high_u8(v0, v1) != uint16x8_t{ 0, 0, 0, 0, 0, 0, 0, 100 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int64x2_t v0{ INT64_MAX, -5 };
+		int64x2_t v1{ -1, 3 };
+		int64x2_t r = vabdq_s64(v0, v1);
+
+		if (r != int64x2_t{ INT64_MIN, 8 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vabs
+	{
+		int16x4_t v0{ -1, 2, -32768, 0 };
+		int16x4_t r = vabs_s16(v0);
+
+		if (r != int16x4_t{ 1, 2, -32768, 0 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		float64x2_t v0{ -1.5, 2.5 };
+		float64x2_t r = vabsq_f64(v0);
+
+		if (r != float64x2_t{ 1.5, 2.5 })
+		{
+			__debugbreak();
+		}
+	}
 
 	// vadd
 	{
@@ -196,21 +279,56 @@ int main()
 
 	// vaddhn
 	{
-		int32x4_t v0{ 1, 2, 3, 4 };
-		int32x4_t v1{ 5, 6, 7, 8 };
+		int32x4_t v0{ 0x10000, 0x7fff0000, -1, 0x12345678 };
+		int32x4_t v1{ 0x8000, 0x10000, 1, 0x10000 };
 		auto r = vaddhn_s32(v0, v1);
-		if (r != int16x4_t{ 6, 8, 10, 12 })
+		if (r != int16x4_t{ 1, INT16_MIN, 0, 0x1235 })
 		{
 			__debugbreak();
 		}
 	}
 
 	{
-		int32x4_t v0{ 1, 2, 3, 4 };
-		int32x4_t v1{ 5, 6, 7, 8 };
+		int32x4_t v0{ 0x10000, 0x7fff0000, -1, 0x12345678 };
+		int32x4_t v1{ 0x8000, 0x10000, 1, 0x10000 };
 		int16x4_t rl{ -1, -2, -3, -4 };
 		auto r = vaddhn_high_s32(rl, v0, v1);
-		if (r != int16x8_t{ -1, -2, -3, -4, 6, 8, 10, 12 })
+		if (r != int16x8_t{ -1, -2, -3, -4, 1, INT16_MIN, 0, 0x1235 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vhadd, vrhadd, vhsub
+	{
+		uint8x16_t v0{ 255, 255, 0, 1, 2, 3, 100, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+		uint8x16_t v1{ 255, 254, 1, 0, 5, 0, 201, 7, 8, 9, 10, 11, 12, 13, 14, 16 };
+
+		if (vrhaddq_u8(v0, v1) != uint8x16_t{ 255, 255, 1, 1, 4, 2, 151, 7, 8, 9, 10, 11, 12, 13, 14, 16 }
+			|| vhaddq_u8(v0, v1) != uint8x16_t{ 255, 254, 0, 0, 3, 1, 150, 7, 8, 9, 10, 11, 12, 13, 14, 15 }
+			|| vhsubq_u8(v0, v1) != uint8x16_t{ 0, 0, 255, 0, 254, 1, 205, 0, 0, 0, 0, 0, 0, 0, 0, 255 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int16x4_t v0{ INT16_MAX, INT16_MIN, -3, 5 };
+		int16x4_t v1{ INT16_MAX, INT16_MAX, 0, -8 };
+
+		if (vrhadd_s16(v0, v1) != int16x4_t{ INT16_MAX, 0, -1, -1 } || vhadd_s16(v0, v1) != int16x4_t{ INT16_MAX, -1, -2, -2 }
+			|| vhsub_s16(v1, v0) != int16x4_t{ 0, INT16_MAX, 1, -7 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int32x4_t v0{ INT32_MAX, INT32_MIN, -3, 5 };
+		int32x4_t v1{ INT32_MAX, INT32_MIN, 0, -8 };
+		uint32x2_t v2{ 0xffffffff, 0 };
+		uint32x2_t v3{ 0xfffffffe, 1 };
+
+		if (vrhaddq_s32(v0, v1) != int32x4_t{ INT32_MAX, INT32_MIN, -1, -1 } || vhsubq_s32(v0, v1) != int32x4_t{ 0, 0, -2, 6 }
+			|| vhadd_u32(v2, v3) != uint32x2_t{ 0xfffffffe, 0 } || vhsub_u32(v2, v3) != uint32x2_t{ 0, 0xffffffff })
 		{
 			__debugbreak();
 		}
@@ -225,7 +343,39 @@ int main()
 			__debugbreak();
 		}
 	}
+	{
+		uint8x16_t v0{ 200, 100, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 255 };
+		if (vaddvq_u8(v0) != uint8_t(646) || vaddlvq_u8(v0) != 646)
+		{
+			__debugbreak();
+		}
+
+		int16x4_t v1{ -32768, -32768, 32767, -1 };
+		if (vaddv_s16(v1) != int16_t(-32770) || vaddlv_s16(v1) != -32770)
+		{
+			__debugbreak();
+		}
+	}
+	{
+		// Pairs are added first: (a0 + a1) + (a2 + a3)
+		float32x4_t v0{ 1e8f, 1.0f, -1e8f, 1.0f };
+		if (vaddvq_f32(v0) != 0.0f)
+		{
+			__debugbreak();
+		}
+	}
+
+	// vand
+	{
+		uint8x8_t v0{ 0xf0, 0x0f, 0xff, 0x00, 0xaa, 0x55, 0x81, 0x18 };
+		uint8x8_t v1{ 0xff, 0xff, 0x0f, 0xff, 0x0f, 0x0f, 0x80, 0x10 };
 
+		auto r = vand_u8(v0, v1);
+		if (r != uint8x8_t{ 0xf0, 0x0f, 0x0f, 0x00, 0x0a, 0x05, 0x80, 0x10 })
+		{
+			__debugbreak();
+		}
+	}
 
 	// vbic
 	{
@@ -246,7 +396,18 @@ int main()
 		int32x4_t v1  { 0b1000, 0b0100, 0b1001, 0b0100 };
 
 		auto r = vbslq_s32(mask, v0, v1);
-		if (r != int32x4_t{ 0, 0, 0, 0b0001 })
+		if (r != int32x4_t{ 0b1100, 0b1100, 0b1001, 0b0101 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		uint32x2_t mask{ 0xffffffff, 0 };
+		float32x2_t v0{ 1.0f, 2.0f };
+		float32x2_t v1{ 3.0f, 4.0f };
+
+		auto r = vbsl_f32(mask, v0, v1);
+		if (r != float32x2_t{ 1.0f, 4.0f })
 		{
 			__debugbreak();
 		}
@@ -259,11 +420,989 @@ int main()
 		int32x4_t v1{ 0b1000, 0b0100, 0b1001, 0b0100 };
 
 		auto r = vbcaxq_s32(mask, v0, v1);
-		if (r != int32x4_t{ 0, 0, 0, 0b0001 })
+		if (r != int32x4_t{ 0, 0, 0b0001, 0b0100 })
+		{
+			__debugbreak();
+		}
+	}
+
+
+	// vceq
+	{
+		float32x4_t v0{ 1.0f, -0.0f, NAN, 4.0f };
+		float32x4_t v1{ 1.0f, 0.0f, NAN, 5.0f };
+		uint32x4_t r = vceqq_f32(v0, v1);
+
+		if (r != uint32x4_t{ 0xffffffff, 0xffffffff, 0, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vcge
+	{
+		int64x2_t v0{ -1, 7 };
+		int64x2_t v1{ 1, 7 };
+		uint64x2_t r = vcgeq_s64(v0, v1);
+
+		if (r != uint64x2_t{ 0, UINT64_MAX })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vcgt
+	{
+		uint8x8_t v0{ 200, 1, 128, 127, 0, 255, 3, 4 };
+		uint8x8_t v1{ 100, 2, 127, 128, 0, 0, 3, 5 };
+		uint8x8_t r = vcgt_u8(v0, v1);
+
+		if (r != uint8x8_t{ 255, 0, 255, 0, 0, 255, 0, 0 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		uint64x2_t v0{ UINT64_MAX, 1 };
+		uint64x2_t v1{ 1, UINT64_MAX };
+		uint64x2_t r = vcgtq_u64(v0, v1);
+
+		if (r != uint64x2_t{ UINT64_MAX, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vcltz
+	{
+		int16x4_t v0{ -1, 0, 1, -32768 };
+		uint16x4_t r = vcltz_s16(v0);
+
+		if (r != uint16x4_t{ 0xffff, 0, 0, 0xffff })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vcagt
+	{
+		float64x2_t v0{ -3.0, NAN };
+		float64x2_t v1{ 2.0, 1.0 };
+		uint64x2_t r = vcagtq_f64(v0, v1);
+
+		if (r != uint64x2_t{ UINT64_MAX, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vcvt
+	{
+		float32x4_t v0{ NAN, 3e9f, -3e9f, -1.75f };
+		if (vcvtq_s32_f32(v0) != int32x4_t{ 0, INT32_MAX, INT32_MIN, -1 } || vcvtq_u32_f32(v0) != uint32x4_t{ 0, 3000000000u, 0, 0 })
+		{
+			__debugbreak();
+		}
+
+		float64x2_t v1{ 1e20, -0.5 };
+		if (vcvtq_u64_f64(v1) != uint64x2_t{ UINT64_MAX, 0 } || vcvtq_s64_f64(v1) != int64x2_t{ INT64_MAX, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vcvt_f16_f32, vcvt_f32_f16 and the _high forms
+	{
+		// 1 + 2^-11 is halfway between two halves and rounds to even
+		float32x4_t v0{ 1.0f, -0.5f, 65504.0f, 1.0f + 1.0f / 2048 };
+		float16x4_t h = vcvt_f16_f32(v0);
+		if (vcvt_f32_f16(h) != float32x4_t{ 1.0f, -0.5f, 65504.0f, 1.0f })
+		{
+			__debugbreak();
+		}
+
+		float16x8_t q = vcvt_high_f16_f32(h, float32x4_t{ 2.0f, 3.0f, 4.0f, 1e6f });
+		if (vcvt_high_f32_f16(q) != float32x4_t{ 2.0f, 3.0f, 4.0f, INFINITY })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		float16x8_t v0 = vcvt_high_f16_f32(vcvt_f16_f32(float32x4_t{ 0.25f, NAN, 1.0f, -2.0f }), float32x4_t{ 2048.0f, -1.5f, 0.0f, 3.0f });
+		float16x8_t v1 = vcvt_high_f16_f32(vcvt_f16_f32(float32x4_t{ 0.25f, 1.0f, 2.0f, -3.0f }), float32x4_t{ 1.0f, 1.5f, -0.0f, 1.0f });
+
+		// 2048 + 1 is not a half and rounds back to 2048
+		float16x8_t r = vaddq_f16(v0, v1);
+		if (vcvt_high_f32_f16(r) != float32x4_t{ 2048.0f, 0.0f, 0.0f, 4.0f })
+		{
+			__debugbreak();
+		}
+
+		uint16x8_t m = vcgeq_f16(v0, v1);
+		if (m != uint16x8_t{ 0xffff, 0, 0, 0xffff, 0xffff, 0, 0xffff, 0xffff })
+		{
+			__debugbreak();
+		}
+	}
+
+	// neon::fpcr_scope
+	{
+		// volatile, so the ops are neither folded nor shared between modes
+		volatile float tiny = 1e-20f;
+		volatile double one = 1.0 + 1.0 / (1 << 30);
+		{
+			neon::fpcr_scope fpcr(neon::fpcr_fz | neon::fpcr_rp);
+			if (vmul_n_f32(vdup_n_f32(tiny), tiny)[0] != 0.0f || vcvt_f32_f64(vdupq_n_f64(one))[0] != 1.0f + 1.0f / (1 << 23))
+			{
+				__debugbreak();
+			}
+		}
+		if (vmul_n_f32(vdup_n_f32(tiny), tiny)[0] == 0.0f || vcvt_f32_f64(vdupq_n_f64(one))[0] != 1.0f || neon::get_fpcr() != 0)
+		{
+			__debugbreak();
+		}
+#if defined(NEON_FPCR_MXCSR)
+		// a mode set on MXCSR directly survives the scope
+		const unsigned csr = _mm_getcsr();
+		_mm_setcsr(csr | 0x6000);
+		{
+			neon::fpcr_scope fpcr(neon::fpcr_fz);
+		}
+		if ((_mm_getcsr() & 0xffc0) != ((csr | 0x6000) & 0xffc0))
+		{
+			__debugbreak();
+		}
+		_mm_setcsr(csr);
+#endif
+	}
+	{
+		uint32_t bits = 0x7fc00001;
+		float32x2_t n;
+		std::memcpy(&n.v_[0], &bits, 4);
+		n.v_[1] = 1.0f;
+
+		float16x4_t d = vcvt_f16_f32(float32x4_t{ 1.0f / (1 << 20), -1.0f / (1 << 20), 1.0f, 0.0f });
+		float16x4_t z = vcvt_f16_f32(float32x4_t{ 0.0f, 0.0f, 0.0f, 0.0f });
+
+		neon::fpcr_scope fpcr(neon::fpcr_dn | neon::fpcr_fz16);
+		float32x2_t r = vadd_f32(n, n);
+		std::memcpy(&bits, &r.v_[0], 4);
+		if (bits != 0x7fc00000 || r[1] != 2.0f)
+		{
+			__debugbreak();
+		}
+
+		// FZ16 flushes half arithmetic, but not the conversions
+		if (vcvt_f32_f16(vadd_f16(d, z)) != float32x4_t{ 0.0f, -0.0f, 1.0f, 0.0f })
+		{
+			__debugbreak();
+		}
+		if (vcgt_f16(d, z) != uint16x4_t{ 0, 0, 0xffff, 0 } || vcvt_f32_f16(d)[0] != 1.0f / (1 << 20))
+		{
+			__debugbreak();
+		}
+	}
+
+
+	// veor3
+	{
+		uint64x2_t v0{ 0b0011, 0 };
+		uint64x2_t v1{ 0b0101, UINT64_MAX };
+		uint64x2_t v2{ 0b1111, 1 };
+
+		auto r = veor3q_u64(v0, v1, v2);
+		if (r != uint64x2_t{ 0b1001, UINT64_MAX - 1 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vfma, vfms
+	{
+		const float e = std::numeric_limits<float>::epsilon();
+		float32x4_t v0{ -1, 1, 2, 0 };
+		float32x4_t v1{ 1 + e, 1 + e, 3, -2 };
+		float32x4_t v2{ 1 - e, 1 - e, 4, 0.5f };
+
+		auto r = vfmaq_f32(v0, v1, v2);
+		if (r != float32x4_t{ -e * e, 2, 14, -1 })
+		{
+			__debugbreak();
+		}
+
+		auto s = vfmsq_f32(v0, v1, v2);
+		if (s != float32x4_t{ -2, e * e, -10, 1 })
+		{
+			__debugbreak();
+		}
+
+		// vmla rounds the product first
+		auto m = vmlaq_f32(v0, v1, v2);
+		if (m != float32x4_t{ 0, 2, 14, -1 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vld1
+	{
+		uint8_t mem[48];
+		for (int i = 0; i < 48; i++) mem[i] = uint8_t(i);
+
+		auto r = vld1q_u8(mem + 1);
+		if (r != uint8x16_t{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 })
+		{
+			__debugbreak();
+		}
+
+		auto r3 = vld1q_u8_x3(mem);
+		if (r3.val[2] != uint8x16_t{ 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		float32_t mem[2] = { 1.5f, -2.0f };
+
+		auto r = vld1q_dup_f32(mem + 1);
+		if (r != float32x4_t{ -2.0f, -2.0f, -2.0f, -2.0f })
+		{
+			__debugbreak();
+		}
+
+		float32x2_t z{ 0.0f, 0.0f };
+		auto rl = vld1_lane_f32(mem, z, 1);
+		if (rl != float32x2_t{ 0.0f, 1.5f })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vld2, vld3, vld4
+	{
+		uint8_t rgb[48];
+		for (int i = 0; i < 48; i++) rgb[i] = uint8_t(i);
+
+		auto r = vld3q_u8(rgb);
+		if (r.val[0] != uint8x16_t{ 0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45 } ||
+			r.val[1] != uint8x16_t{ 1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46 } ||
+			r.val[2] != uint8x16_t{ 2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 32, 35, 38, 41, 44, 47 })
 		{
 			__debugbreak();
 		}
 	}
+	{
+		float32_t cplx[8] = { 1, -1, 2, -2, 3, -3, 4, -4 };
 
+		auto r = vld2q_f32(cplx);
+		if (r.val[0] != float32x4_t{ 1, 2, 3, 4 } || r.val[1] != float32x4_t{ -1, -2, -3, -4 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int16_t mem[16];
+		for (int i = 0; i < 16; i++) mem[i] = int16_t(-i);
+
+		auto r = vld4_s16(mem);
+		if (r.val[0] != int16x4_t{ 0, -4, -8, -12 } || r.val[3] != int16x4_t{ -3, -7, -11, -15 })
+		{
+			__debugbreak();
+		}
+
+		auto d = vld4_dup_s16(mem + 4);
+		if (d.val[0] != int16x4_t{ -4, -4, -4, -4 } || d.val[3] != int16x4_t{ -7, -7, -7, -7 })
+		{
+			__debugbreak();
+		}
+
+		auto l = vld4_lane_s16(mem + 8, d, 1);
+		if (l.val[0] != int16x4_t{ -4, -8, -4, -4 } || l.val[3] != int16x4_t{ -7, -11, -7, -7 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vmaxv, vminv, vmaxnmv, vminnmv
+	{
+		int8x16_t v0{ 3, -7, 100, -128, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, -1 };
+		if (vmaxvq_s8(v0) != 100 || vminvq_s8(v0) != -128)
+		{
+			__debugbreak();
+		}
+
+		uint16x4_t v1{ 9, 65535, 0, 7 };
+		if (vmaxv_u16(v1) != 65535 || vminv_u16(v1) != 0)
+		{
+			__debugbreak();
+		}
+	}
+	{
+		float32x4_t v0{ -0.0f, 0.0f, NAN, -2.0f };
+		if (!std::isnan(vmaxvq_f32(v0)) || vmaxnmvq_f32(v0) != 0.0f || vminnmvq_f32(v0) != -2.0f)
+		{
+			__debugbreak();
+		}
+
+		float32x2_t v1{ 0.0f, -0.0f };
+		if (!std::signbit(vminv_f32(v1)) || std::signbit(vmaxv_f32(v1)))
+		{
+			__debugbreak();
+		}
+	}
+
+	// vmul, vmla, vmls
+	{
+		uint8x8_t v0{ 1, 2, 3, 4, 5, 6, 7, 255 };
+		uint8x8_t v1{ 2, 128, 100, 64, 51, 1, 0, 255 };
+
+		auto r = vmul_u8(v0, v1);
+		if (r != uint8x8_t{ 2, 0, 44, 0, 255, 6, 0, 1 })
+		{
+			__debugbreak();
+		}
+
+		auto a = vmla_u8(v1, v0, v0);
+		if (a != uint8x8_t{ 3, 132, 109, 80, 76, 37, 49, 0 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int32x4_t v0{ 100, -7, 0x10000, INT32_MIN };
+		int32x4_t v1{ 3, 6, 0x10000, -1 };
+
+		auto r = vmulq_s32(v0, v1);
+		if (r != int32x4_t{ 300, -42, 0, INT32_MIN })
+		{
+			__debugbreak();
+		}
+
+		auto s = vmlsq_s32(v1, v0, v1);
+		if (s != int32x4_t{ -297, 48, 0x10000, INT32_MAX })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vmull, vmlal
+	{
+		int16x4_t v0{ -32768, 32767, -2, 1000 };
+		int16x4_t v1{ -32768, 32767, 3, -1000 };
+
+		auto r = vmull_s16(v0, v1);
+		if (r != int32x4_t{ 1 << 30, 32767 * 32767, -6, -1000000 })
+		{
+			__debugbreak();
+		}
+
+		int32x4_t acc{ 1, 2, 3, 4 };
+		auto m = vmlal_s16(acc, v0, v1);
+		if (m != int32x4_t{ (1 << 30) + 1, 32767 * 32767 + 2, -3, -999996 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		uint32x4_t v0{ 1, 2, 0xffffffff, 0x80000000 };
+		uint32x4_t v1{ 1, 2, 0xffffffff, 4 };
+
+		auto r = vmull_high_u32(v0, v1);
+		if (r != uint64x2_t{ 0xfffffffe00000001ull, 0x200000000ull })
+		{
+			__debugbreak();
+		}
+
+		auto s = vmlsl_high_u32(uint64x2_t{ 0, 0x200000000ull }, v0, v1);
+		if (s != uint64x2_t{ 0x1ffffffffull, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vmul_n, vmul_lane, vmla_laneq, vmull_lane
+	{
+		int16x8_t v0{ 1, 2, 3, 4, 5, 6, 7, 8 };
+		int16x4_t c{ 10, -20, 30, -40 };
+
+		auto r = vmulq_lane_s16(v0, c, 1);
+		if (r != int16x8_t{ -20, -40, -60, -80, -100, -120, -140, -160 } || r != vmulq_n_s16(v0, -20))
+		{
+			__debugbreak();
+		}
+
+		auto m = vmlaq_laneq_s16(v0, v0, v0, 7);
+		if (m != int16x8_t{ 9, 18, 27, 36, 45, 54, 63, 72 })
+		{
+			__debugbreak();
+		}
+
+		auto l = vmull_lane_s16(c, c, 3);
+		if (l != int32x4_t{ -400, 800, -1200, 1600 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		float32x4_t v0{ 1, 2, 3, 4 };
+		float32x2_t c{ 0.5f, -2 };
+
+		auto r = vfmaq_lane_f32(v0, v0, c, 1);
+		if (r != float32x4_t{ -1, -2, -3, -4 } || vdupq_lane_f32(c, 0) != float32x4_t{ 0.5f, 0.5f, 0.5f, 0.5f })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vmovl, vmovn, vqmovn, vqmovun
+	{
+		uint8x16_t v0{ 0, 1, 127, 128, 200, 255, 7, 8, 9, 10, 11, 12, 13, 14, 250, 251 };
+		int8x8_t v1{ -128, -1, 0, 1, 127, 2, 3, 4 };
+
+		if (vmovl_u8(vget_low_u8(v0)) != uint16x8_t{ 0, 1, 127, 128, 200, 255, 7, 8 } || vmovl_high_u8(v0) != uint16x8_t{ 9, 10, 11, 12, 13, 14, 250, 251 }
+			|| vmovl_s8(v1) != int16x8_t{ -128, -1, 0, 1, 127, 2, 3, 4 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		neon::fpsr_qc() = false;
+		int16x8_t v0{ 0x1234, -1, 255, 256, -129, 127, -128, 0 };
+
+		if (vmovn_s16(v0) != int8x8_t{ 0x34, -1, -1, 0, 127, 127, -128, 0 } || neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		if (vqmovn_s16(v0) != int8x8_t{ 127, -1, 127, 127, -128, 127, -128, 0 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		neon::fpsr_qc() = false;
+		if (vqmovun_s16(v0) != uint8x8_t{ 255, 0, 255, 255, 0, 127, 0, 0 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+	{
+		neon::fpsr_qc() = false;
+		uint16x4_t rl{ 1, 2, 3, 4 };
+		uint32x4_t v0{ 5, 0xffff, 0x10000, 0xffffffff };
+
+		if (vmovn_high_u32(rl, v0) != uint16x8_t{ 1, 2, 3, 4, 5, 0xffff, 0, 0xffff } || neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		if (vqmovn_high_u32(rl, v0) != uint16x8_t{ 1, 2, 3, 4, 5, 0xffff, 0xffff, 0xffff } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+	{
+		neon::fpsr_qc() = false;
+		uint32x2_t rl{ 1, 2 };
+		int64x2_t v0{ 0xffffffff, 7 };
+
+		if (vqmovun_high_s64(rl, v0) != uint32x4_t{ 1, 2, 0xffffffff, 7 } || neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		int64x2_t v1{ INT64_MIN, 0x100000000 };
+		if (vqmovun_s64(v1) != uint32x2_t{ 0, 0xffffffff } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+
+	// vmvn
+	{
+		int16x8_t v0{ 0, -1, 1, 0x7fff, -32768, 2, 3, 4 };
+
+		auto r = vmvnq_s16(v0);
+		if (r != int16x8_t{ -1, 0, -2, -32768, 0x7fff, -3, -4, -5 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vorn
+	{
+		uint32x2_t v0{ 0x0000ff00, 0 };
+		uint32x2_t v1{ 0xffff0000, 0xffffffff };
+
+		auto r = vorn_u32(v0, v1);
+		if (r != uint32x2_t{ 0x0000ffff, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+
+	// vpadd, vpaddl, vpadal
+	{
+		uint8x8_t v0{ 1, 2, 3, 4, 200, 100, 255, 1 };
+		uint8x8_t v1{ 10, 20, 30, 40, 50, 60, 70, 80 };
+
+		auto r = vpadd_u8(v0, v1);
+		if (r != uint8x8_t{ 3, 7, 44, 0, 30, 70, 110, 150 })
+		{
+			__debugbreak();
+		}
+
+		auto l = vpaddl_u8(v0);
+		if (l != uint16x4_t{ 3, 7, 300, 256 })
+		{
+			__debugbreak();
+		}
+
+		auto a = vpadal_u8(uint16x4_t{ 1, 2, 3, 65535 }, v0);
+		if (a != uint16x4_t{ 4, 9, 303, 255 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int16x8_t v0{ -32768, -32768, 32767, 32767, 1, -1, 5, 6 };
+		if (vpaddlq_s16(v0) != int32x4_t{ -65536, 65534, 0, 11 })
+		{
+			__debugbreak();
+		}
+
+		float64x2_t v1{ 1.5, 2.0 };
+		if (vpaddq_f64(v1, v1) != float64x2_t{ 3.5, 3.5 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vqadd, vqsub
+	{
+		neon::fpsr_qc() = false;
+		int8x8_t v0{ 100, -100, 1, 127, -128, 0, 50, -50 };
+		int8x8_t v1{ 100, -100, 1, 1, -1, 0, 50, -50 };
+
+		auto r = vqadd_s8(v0, v1);
+		if (r != int8x8_t{ 127, -128, 2, 127, -128, 0, 100, -100 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+	{
+		neon::fpsr_qc() = false;
+		uint32x4_t v0{ 5, 1, 0, 0xffffffff };
+		uint32x4_t v1{ 3, 1, 0, 0xfffffffe };
+
+		auto r = vqsubq_u32(v0, v1);
+		if (r != uint32x4_t{ 2, 0, 0, 1 } || neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		r = vqsubq_u32(v1, v0);
+		if (r != uint32x4_t{ 0, 0, 0, 0 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+	{
+		neon::fpsr_qc() = false;
+		int64x2_t v0{ INT64_MAX, INT64_MIN };
+		int64x2_t v1{ 1, 1 };
+
+		auto r = vqsubq_s64(v0, v1);
+		if (r != int64x2_t{ INT64_MAX - 1, INT64_MIN } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+
+	// vshl_n, vshr_n, vrshr_n, vsra_n
+	{
+		int16x8_t v0{ 1, -1, 100, -100, 32767, -32768, 7, -7 };
+
+		if (vshlq_n_s16(v0, 3) != int16x8_t{ 8, -8, 800, -800, -8, 0, 56, -56 })
+		{
+			__debugbreak();
+		}
+
+		if (vshrq_n_s16(v0, 2) != int16x8_t{ 0, -1, 25, -25, 8191, -8192, 1, -2 })
+		{
+			__debugbreak();
+		}
+
+		if (vrshrq_n_s16(v0, 2) != int16x8_t{ 0, 0, 25, -25, 8192, -8192, 2, -2 })
+		{
+			__debugbreak();
+		}
+
+		if (vshrq_n_s16(v0, 16) != int16x8_t{ 0, -1, 0, -1, 0, -1, 0, -1 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		uint8x8_t v0{ 255, 128, 127, 1, 0, 200, 64, 63 };
+
+		if (vrshr_n_u8(v0, 8) != uint8x8_t{ 1, 1, 0, 0, 0, 1, 0, 0 } || vshr_n_u8(v0, 8) != uint8x8_t{})
+		{
+			__debugbreak();
+		}
+
+		uint32x2_t v1{ 10, 0xffffffff };
+		uint32x2_t v2{ 0x100, 0x10 };
+
+		if (vsra_n_u32(v1, v2, 4) != uint32x2_t{ 26, 0 } || vrsra_n_u32(v1, v2, 5) != uint32x2_t{ 18, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vsli_n, vsri_n
+	{
+		uint8x8_t v0{ 0xff, 0xff, 0, 0, 0x5a, 0xa5, 0x0f, 0xf0 };
+		uint8x8_t v1{ 0x01, 0x0f, 0xff, 0x10, 0xa5, 0x5a, 0xf0, 0x0f };
+
+		if (vsli_n_u8(v0, v1, 4) != uint8x8_t{ 0x1f, 0xff, 0xf0, 0x00, 0x5a, 0xa5, 0x0f, 0xf0 })
+		{
+			__debugbreak();
+		}
+
+		if (vsri_n_u8(v0, v1, 4) != uint8x8_t{ 0xf0, 0xf0, 0x0f, 0x01, 0x5a, 0xa5, 0x0f, 0xf0 })
+		{
+			__debugbreak();
+		}
+
+		if (vsri_n_u8(v0, v1, 8) != v0 || vsli_n_u8(v0, v1, 0) != v1)
+		{
+			__debugbreak();
+		}
+	}
+
+	// vshrn_n, vrshrn_n, vqshrn_n, vqrshrn_n
+	{
+		neon::fpsr_qc() = false;
+		int32x4_t v0{ 1000, -1000, 0x7fffffff, INT32_MIN };
+
+		if (vshrn_n_s32(v0, 4) != int16x4_t{ 62, -63, -1, 0 } || vrshrn_n_s32(v0, 4) != int16x4_t{ 63, -62, 0, 0 } || neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		if (vqshrn_n_s32(v0, 4) != int16x4_t{ 62, -63, INT16_MAX, INT16_MIN } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+	{
+		neon::fpsr_qc() = false;
+		uint16x8_t v0{ 0xffff, 0x1ff, 0x100, 0xff, 0x80, 0x7f, 1, 0 };
+
+		if (vqrshrn_n_u16(v0, 8) != uint8x8_t{ 255, 2, 1, 1, 1, 0, 0, 0 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+
+	// vshl, vrshl, vqshl
+	{
+		neon::fpsr_qc() = false;
+		int32x4_t v0{ 5, -5, 0x40000000, -7 };
+		int32x4_t v1{ 2, -1, 1, -40 };
+
+		if (vshlq_s32(v0, v1) != int32x4_t{ 20, -3, INT32_MIN, -1 } || vrshlq_s32(v0, v1) != int32x4_t{ 20, -2, INT32_MIN, 0 } || neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		if (vqshlq_s32(v0, v1) != int32x4_t{ 20, -3, INT32_MAX, -1 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+	{
+		neon::fpsr_qc() = false;
+		uint16x4_t v0{ 3, 0x8000, 0xffff, 9 };
+		int16x4_t v1{ 15, -16, -17, -2 };
+
+		if (vshl_u16(v0, v1) != uint16x4_t{ 0x8000, 0, 0, 2 } || vrshl_u16(v0, v1) != uint16x4_t{ 0x8000, 1, 0, 2 })
+		{
+			__debugbreak();
+		}
+
+		if (vqshl_u16(v0, v1) != uint16x4_t{ 0xffff, 0, 0, 2 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+	{
+		neon::fpsr_qc() = false;
+		int8x8_t v0{ 1, -1, 64, -64, 3, 100, -128, 0 };
+		int8x8_t v1{ 7, 7, 1, 1, -1, -8, -128, 127 };
+
+		if (vqshl_s8(v0, v1) != int8x8_t{ 127, -128, 127, -128, 1, 0, -1, 0 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		if (vrshl_s8(v0, v1) != int8x8_t{ -128, -128, -128, -128, 2, 0, 0, 0 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vqabs, vqneg
+	{
+		neon::fpsr_qc() = false;
+		int32x2_t v0{ INT32_MIN, -7 };
+
+		if (vqabs_s32(v0) != int32x2_t{ INT32_MAX, 7 } || vqneg_s32(v0) != int32x2_t{ INT32_MAX, 7 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+	}
+
+	// vqdmulh, vqrdmulh
+	{
+		neon::fpsr_qc() = false;
+		int16x8_t v0{ 16384, -32768, 1000, -1000, 3, 0x4000, 0x7fff, -32768 };
+		int16x8_t v1{ 16384, -32768, 1000, 1000, 5, 1, 0x7fff, 32767 };
+
+		auto r = vqrdmulhq_s16(v0, v1);
+		if (r != int16x8_t{ 8192, 32767, 31, -31, 0, 1, 32766, -32767 } || !neon::fpsr_qc())
+		{
+			__debugbreak();
+		}
+
+		auto h = vqdmulhq_s16(v0, v1);
+		if (h != int16x8_t{ 8192, 32767, 30, -31, 0, 0, 32766, -32767 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int32x4_t v0{ 1 << 30, INT32_MIN, -3, INT32_MAX };
+		int32x4_t v1{ 1 << 30, INT32_MIN, 1 << 30, INT32_MAX };
+
+		auto r = vqrdmulhq_s32(v0, v1);
+		if (r != int32x4_t{ 1 << 29, INT32_MAX, -1, INT32_MAX - 1 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vst1
+	{
+		int16_t mem[9] = {};
+		int16x4_t v{ 5, 6, 7, 8 };
+		vst1_s16(mem + 1, int16x4_t{ 1, -2, 3, -4 });
+		vst1_lane_s16(mem + 8, v, 2);
+		if (mem[0] != 0 || mem[1] != 1 || mem[2] != -2 || mem[3] != 3 || mem[4] != -4 || mem[5] != 0 || mem[8] != 7)
+		{
+			__debugbreak();
+		}
+	}
+	{
+		uint64_t mem[4] = {};
+		uint64x2x2_t v{ { uint64x2_t{ 1, 2 }, uint64x2_t{ 3, UINT64_MAX } } };
+		vst1q_u64_x2(mem, v);
+		if (mem[0] != 1 || mem[1] != 2 || mem[2] != 3 || mem[3] != UINT64_MAX)
+		{
+			__debugbreak();
+		}
+	}
+
+
+	// vst2, vst3, vst4
+	{
+		uint8_t rgba[64];
+		uint8x16x4_t v;
+		v.val[0] = vld1q_dup_u8((uint8_t const*)"\x10");
+		v.val[1] = vld1q_dup_u8((uint8_t const*)"\x20");
+		v.val[2] = vld1q_dup_u8((uint8_t const*)"\x30");
+		v.val[3] = vld1q_dup_u8((uint8_t const*)"\x40");
+		vst4q_u8(rgba, v);
+		for (int i = 0; i < 64; i++)
+		{
+			if (rgba[i] != 0x10 * (i % 4 + 1))
+			{
+				__debugbreak();
+			}
+		}
+	}
+	{
+		uint32_t mem[6] = {};
+		uint32x2x3_t v{ { uint32x2_t{ 1, 2 }, uint32x2_t{ 3, 4 }, uint32x2_t{ 5, 6 } } };
+		vst3_u32(mem, v);
+		if (mem[0] != 1 || mem[1] != 3 || mem[2] != 5 || mem[3] != 2 || mem[4] != 4 || mem[5] != 6)
+		{
+			__debugbreak();
+		}
+
+		vst3_lane_u32(mem, v, 1);
+		if (mem[0] != 2 || mem[1] != 4 || mem[2] != 6)
+		{
+			__debugbreak();
+		}
+	}
+
+	// vtbl, vtbx, vqtbl, vqtbx
+	{
+		uint8x8x3_t t{ { uint8x8_t{ 0, 1, 2, 3, 4, 5, 6, 7 }, uint8x8_t{ 8, 9, 10, 11, 12, 13, 14, 15 }, uint8x8_t{ 16, 17, 18, 19, 20, 21, 22, 23 } } };
+		uint8x8_t idx{ 0, 23, 24, 8, 255, 17, 31, 5 };
+
+		auto r = vtbl3_u8(t, idx);
+		if (r != uint8x8_t{ 0, 23, 0, 8, 0, 17, 0, 5 })
+		{
+			__debugbreak();
+		}
+
+		auto x = vtbx3_u8(uint8x8_t{ 9, 9, 9, 9, 9, 9, 9, 9 }, t, idx);
+		if (x != uint8x8_t{ 0, 23, 9, 8, 9, 17, 9, 5 })
+		{
+			__debugbreak();
+		}
+
+		auto one = vtbl1_u8(t.val[1], uint8x8_t{ 7, 6, 8, 0, 1, 2, 3, 4 });
+		if (one != uint8x8_t{ 15, 14, 0, 8, 9, 10, 11, 12 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int8x16x4_t t;
+		for (int j = 0; j < 4; j++)
+			for (int i = 0; i < 16; i++)
+				t.val[j].v_[i] = int8_t(-(16 * j + i));
+		uint8x16_t idx{ 0, 63, 64, 16, 32, 48, 200, 15, 31, 47, 1, 2, 3, 128, 60, 33 };
+
+		auto r = vqtbl4q_s8(t, idx);
+		if (r != int8x16_t{ 0, -63, 0, -16, -32, -48, 0, -15, -31, -47, -1, -2, -3, 0, -60, -33 })
+		{
+			__debugbreak();
+		}
+
+		auto x = vqtbx1q_s8(vdupq_n_s8(100), t.val[2], idx);
+		if (x != int8x16_t{ -32, 100, 100, 100, 100, 100, 100, -47, 100, 100, -33, -34, -35, 100, 100, 100 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vzip, vuzp, vtrn
+	{
+		uint8x8_t v0{ 0, 1, 2, 3, 4, 5, 6, 7 };
+		uint8x8_t v1{ 10, 11, 12, 13, 14, 15, 16, 17 };
+
+		auto z = vzip_u8(v0, v1);
+		if (z.val[0] != uint8x8_t{ 0, 10, 1, 11, 2, 12, 3, 13 } || z.val[1] != uint8x8_t{ 4, 14, 5, 15, 6, 16, 7, 17 })
+		{
+			__debugbreak();
+		}
+
+		auto u = vuzp_u8(v0, v1);
+		if (u.val[0] != uint8x8_t{ 0, 2, 4, 6, 10, 12, 14, 16 } || u.val[1] != uint8x8_t{ 1, 3, 5, 7, 11, 13, 15, 17 })
+		{
+			__debugbreak();
+		}
+
+		auto t = vtrn_u8(v0, v1);
+		if (t.val[0] != uint8x8_t{ 0, 10, 2, 12, 4, 14, 6, 16 } || t.val[1] != uint8x8_t{ 1, 11, 3, 13, 5, 15, 7, 17 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		float32x4_t v0{ 1, 2, 3, 4 };
+		float32x4_t v1{ 5, 6, 7, 8 };
+
+		auto z = vzipq_f32(v0, v1);
+		if (z.val[0] != float32x4_t{ 1, 5, 2, 6 } || z.val[1] != float32x4_t{ 3, 7, 4, 8 })
+		{
+			__debugbreak();
+		}
+
+		if (vuzp1q_f32(v0, v1) != float32x4_t{ 1, 3, 5, 7 } || vtrn1q_f32(v0, v1) != float32x4_t{ 1, 5, 3, 7 })
+		{
+			__debugbreak();
+		}
+	}
+	{
+		int16x8_t v0{ 0, 1, 2, 3, 4, 5, 6, 7 };
+		int16x8_t v1{ 10, 11, 12, 13, 14, 15, 16, 17 };
+
+		if (vzip1q_s16(v0, v1) != int16x8_t{ 0, 10, 1, 11, 2, 12, 3, 13 } ||
+			vuzp2q_s16(v0, v1) != int16x8_t{ 1, 3, 5, 7, 11, 13, 15, 17 } ||
+			vtrn2q_s16(v0, v1) != int16x8_t{ 1, 11, 3, 13, 5, 15, 7, 17 })
+		{
+			__debugbreak();
+		}
+
+		int64x2_t v2{ 1, 2 };
+		int64x2_t v3{ 3, 4 };
+
+		if (vzip2q_s64(v2, v3) != int64x2_t{ 2, 4 } || vuzp1q_s64(v2, v3) != int64x2_t{ 1, 3 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vext
+	{
+		uint8x16_t v0{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+		uint8x16_t v1{ 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 };
+
+		if (vextq_u8(v0, v1, 3) != uint8x16_t{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18 } || vextq_u8(v0, v1, 0) != v0)
+		{
+			__debugbreak();
+		}
+
+		int16x4_t v2{ 0, 1, 2, 3 };
+		int16x4_t v3{ 4, 5, 6, 7 };
+
+		if (vext_s16(v2, v3, 1) != int16x4_t{ 1, 2, 3, 4 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vrev16, vrev32, vrev64
+	{
+		uint8x16_t v0{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+		if (vrev16q_u8(v0) != uint8x16_t{ 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 })
+		{
+			__debugbreak();
+		}
+
+		if (vrev32_u8(vget_low_u8(v0)) != uint8x8_t{ 3, 2, 1, 0, 7, 6, 5, 4 })
+		{
+			__debugbreak();
+		}
+
+		if (vrev64q_s16(int16x8_t{ 0, 1, 2, 3, 4, 5, 6, 7 }) != int16x8_t{ 3, 2, 1, 0, 7, 6, 5, 4 } || vrev64_f32(float32x2_t{ 1, 2 }) != float32x2_t{ 2, 1 })
+		{
+			__debugbreak();
+		}
+	}
+
+	// vcombine, vget_low, vget_high
+	{
+		int32x2_t v0{ 1, 2 };
+		int32x2_t v1{ 3, 4 };
+
+		auto q = vcombine_s32(v0, v1);
+		if (q != int32x4_t{ 1, 2, 3, 4 } || vget_low_s32(q) != v0 || vget_high_s32(q) != v1)
+		{
+			__debugbreak();
+		}
+
+		if (vget_high_f64(float64x2_t{ 1.5, 2.5 }) != float64x1_t{ 2.5 })
+		{
+			__debugbreak();
+		}
+	}
 
 }
\ No newline at end of file
@@ -0,0 +1,639 @@
+// Differential validator: every backend the host can run against the scalar
+// reference, bit for bit, for every function in the generated api. Lane and
+// immediate forms (vmul_lane, vshl_n, vext, ...) are checked at their lowest,
+// middle and highest lane or immediate.
+//
+//   python3 api.py --dispatch > neon_api.h
+//   g++ -std=c++14 -O2 -pthread -I. validate.cpp -o validate
+//   ./validate [--filter vqadd] [--threads n] [--samples n] [--sweep-bits 32] [--exact-nan]
+//
+// Functions whose register arguments have 8- or 16-bit lanes adding up to at
+// most --sweep-bits (32) are swept exhaustively, one operand combination per
+// lane: all 2^16 pairs of an 8-bit binary op, all 2^32 of a 16-bit one. The
+// rest (wider lanes, loads, stores, tables, scalar operands) get --samples
+// random calls biased towards edge values. Work is handed out in chunks to a
+// thread pool and inputs are built in registers, so a sweep is bound by the
+// ops alone. Lower --sweep-bits to sample the 16-bit pairs on small hosts.
+//
+// The QC flag is compared along with the result, and stores are compared
+// through their memory. The first mismatch per function and backend is
+// reported with its lane and operands; NaN lanes match any NaN unless
+// --exact-nan. The exit code is 1 on any mismatch.
+
+#include "neon_api.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace validate {
+
+	struct options
+	{
+		std::string filter;
+		unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+		uint64_t samples = 1 << 16;
+		unsigned sweep_bits = 32;
+		bool exact_nan = false;
+	};
+
+	static options o;
+	static int top = NEON_BACKEND_SCALAR;
+
+	template <size_t Bytes> struct uint_of;
+	template <> struct uint_of<1> { using type = uint8_t; };
+	template <> struct uint_of<2> { using type = uint16_t; };
+	template <> struct uint_of<4> { using type = uint32_t; };
+	template <> struct uint_of<8> { using type = uint64_t; };
+
+	// Lane bits an argument contributes to an exhaustive sweep (0 when it
+	// can't be swept) and the lanes it has.
+	template <typename T>
+	struct sweep
+	{
+		static constexpr unsigned bits = 0;
+		static constexpr unsigned lanes = 0;
+	};
+
+	template <typename T>
+	struct sweep<neon::neon64<T>>
+	{
+		static constexpr unsigned bits = sizeof(T) <= 2 ? 8 * sizeof(T) : 0;
+		static constexpr unsigned lanes = neon::neon64<T>::N;
+	};
+
+	template <typename T>
+	struct sweep<neon::neon128<T>>
+	{
+		static constexpr unsigned bits = sizeof(T) <= 2 ? 8 * sizeof(T) : 0;
+		static constexpr unsigned lanes = neon::neon128<T>::N;
+	};
+
+	template <typename V, size_t Count>
+	struct sweep<neon::neon_tuple<V, Count>>
+	{
+		static constexpr unsigned bits = 0;
+		static constexpr unsigned lanes = V::N;
+	};
+
+	struct task;
+
+	struct entry
+	{
+		const char* name;
+		void (*plan)(task& t);
+		void (*run)(task& t, uint64_t begin, uint64_t end);
+	};
+
+	struct task
+	{
+		entry const* e;
+		bool exhaustive = false;
+		unsigned bits = 0;  // swept operand bits when exhaustive
+		unsigned lanes = 1; // operand combinations per call
+		uint64_t calls = 0;
+		std::atomic<uint64_t> next{ 0 };
+		std::atomic<int> failed{ 0 }; // bit per backend
+		std::mutex m;
+		std::string mismatch[NEON_BACKEND_AVX512 + 1];
+	};
+
+	// Per-thread memory behind pointer arguments: loads read in, stores write
+	// out[0] for the reference and out[1] for the backend.
+	struct scratch
+	{
+		alignas(64) unsigned char in[64];
+		alignas(64) unsigned char out[2][64];
+	};
+
+	template <typename T>
+	typename std::enable_if<neon::is_integer<T>::value, T>::type
+		random_lane(std::mt19937_64& rng)
+	{
+		switch (rng() % 8)
+		{
+		case 0: return std::numeric_limits<T>::min();
+		case 1: return std::numeric_limits<T>::max();
+		case 2: return T(0);
+		case 3: return T(rng() % 3 - 1);
+		default: return T(rng());
+		}
+	}
+
+	// Zeroes, infinities, NaNs, denormals and the largest finite values a
+	// quarter of the time, any bit pattern a quarter, ordinary values the rest.
+	template <typename T>
+	typename std::enable_if<neon::is_ieee754<T>::value, T>::type
+		random_lane(std::mt19937_64& rng)
+	{
+		using itype = typename uint_of<sizeof(T)>::type;
+		constexpr int mantissa = sizeof(T) == 2 ? 10 : sizeof(T) == 4 ? 23 : 52;
+		constexpr itype sign = itype(itype(1) << (8 * sizeof(T) - 1));
+		constexpr itype exponent = itype(itype(~sign) & ~itype((itype(1) << mantissa) - 1));
+		static const itype special[] = { 0, exponent, itype(exponent | (itype(1) << (mantissa - 1))), itype(exponent | 1), 1, itype(exponent - 1), itype((itype(1) << mantissa) - 1) };
+
+		itype raw;
+		T r;
+		switch (rng() % 8)
+		{
+		case 0:
+		case 1:
+			raw = itype(special[rng() % (sizeof(special) / sizeof(special[0]))] | (rng() % 2 ? sign : 0));
+			break;
+		case 2:
+		case 3:
+			raw = itype(rng());
+			break;
+		default:
+			r = T(std::uniform_real_distribution<float>(-1000.0f, 1000.0f)(rng));
+			return r;
+		}
+		std::memcpy(&r, &raw, sizeof(T));
+		return r;
+	}
+
+	template <typename T>
+	void fill(T& v, std::mt19937_64& rng, scratch&, unsigned)
+	{
+		v = random_lane<T>(rng);
+	}
+
+	template <typename T>
+	void fill(neon::neon64<T>& v, std::mt19937_64& rng, scratch&, unsigned)
+	{
+		for (size_t i = 0; i < v.N; i++)
+			v.v_[i] = random_lane<T>(rng);
+	}
+
+	template <typename T>
+	void fill(neon::neon128<T>& v, std::mt19937_64& rng, scratch&, unsigned)
+	{
+		for (size_t i = 0; i < v.N; i++)
+			v.v_[i] = random_lane<T>(rng);
+	}
+
+	template <typename V, size_t Count>
+	void fill(neon::neon_tuple<V, Count>& v, std::mt19937_64& rng, scratch& s, unsigned lanes)
+	{
+		for (auto& r : v.val)
+			fill(r, rng, s, lanes);
+	}
+
+	template <typename T>
+	void fill(T const*& p, std::mt19937_64& rng, scratch& s, unsigned)
+	{
+		for (size_t i = 0; i < sizeof(s.in); i += sizeof(T))
+		{
+			T lane = random_lane<T>(rng);
+			std::memcpy(s.in + i, &lane, sizeof(T));
+		}
+		p = reinterpret_cast<T const*>(s.in);
+	}
+
+	template <typename T>
+	void fill(T*& p, std::mt19937_64&, scratch& s, unsigned)
+	{
+		p = reinterpret_cast<T*>(s.out[0]);
+	}
+
+	template <typename T>
+	void retarget(T&, scratch&)
+	{
+	}
+
+	template <typename T>
+	void retarget(T*& p, scratch& s)
+	{
+		p = reinterpret_cast<T*>(s.out[1]);
+	}
+
+	template <typename T>
+	void retarget(T const*&, scratch&)
+	{
+	}
+
+	// Lane l of a swept argument holds bits [shift, shift + lane bits) of
+	// operand combination first + l % lanes.
+	template <typename T>
+	void set_sweep(T&, uint64_t, unsigned, unsigned)
+	{
+	}
+
+	template <typename V>
+	void set_lanes(V& v, uint64_t first, unsigned lanes, unsigned shift)
+	{
+		using T = typename V::type;
+		for (size_t l = 0; l < V::N; l++)
+		{
+			auto raw = typename uint_of<sizeof(T)>::type((first + l % lanes) >> shift);
+			T lane;
+			std::memcpy(&lane, &raw, sizeof(T));
+			v.v_[l] = lane;
+		}
+	}
+
+	template <typename T>
+	void set_sweep(neon::neon64<T>& v, uint64_t first, unsigned lanes, unsigned shift)
+	{
+		set_lanes(v, first, lanes, shift);
+	}
+
+	template <typename T>
+	void set_sweep(neon::neon128<T>& v, uint64_t first, unsigned lanes, unsigned shift)
+	{
+		set_lanes(v, first, lanes, shift);
+	}
+
+	template <typename T>
+	bool same_lane(T a, T b)
+	{
+		if (neon::is_ieee754<T>::value && !o.exact_nan && a != a && b != b)
+			return true;
+		return std::memcmp(&a, &b, sizeof(T)) == 0;
+	}
+
+	// Index of the first differing lane, or -1.
+	template <typename T>
+	int first_diff(T const& a, T const& b)
+	{
+		return same_lane(a, b) ? -1 : 0;
+	}
+
+	template <typename T>
+	int first_diff(neon::neon64<T> const& a, neon::neon64<T> const& b)
+	{
+		for (int i = 0; i < int(a.N); i++)
+			if (!same_lane(a[i], b[i]))
+				return i;
+		return -1;
+	}
+
+	template <typename T>
+	int first_diff(neon::neon128<T> const& a, neon::neon128<T> const& b)
+	{
+		for (int i = 0; i < int(a.N); i++)
+			if (!same_lane(a[i], b[i]))
+				return i;
+		return -1;
+	}
+
+	template <typename V, size_t Count>
+	int first_diff(neon::neon_tuple<V, Count> const& a, neon::neon_tuple<V, Count> const& b)
+	{
+		for (size_t r = 0; r < Count; r++)
+		{
+			int i = first_diff(a.val[r], b.val[r]);
+			if (i >= 0)
+				return int(r * V::N) + i;
+		}
+		return -1;
+	}
+
+	template <typename T>
+	std::string hex(T v)
+	{
+		typename uint_of<sizeof(T)>::type raw;
+		std::memcpy(&raw, &v, sizeof(T));
+		char s[24];
+		std::snprintf(s, sizeof(s), "0x%0*llx", int(2 * sizeof(T)), (unsigned long long)raw);
+		return s;
+	}
+
+	template <typename T>
+	std::string describe(T const& v)
+	{
+		return hex(v);
+	}
+
+	template <typename V>
+	std::string describe_lanes(V const& v)
+	{
+		std::string s = "{";
+		for (size_t i = 0; i < V::N; i++)
+			s += (i ? ", " : "") + hex(v[int(i)]);
+		return s + "}";
+	}
+
+	template <typename T>
+	std::string describe(neon::neon64<T> const& v)
+	{
+		return describe_lanes(v);
+	}
+
+	template <typename T>
+	std::string describe(neon::neon128<T> const& v)
+	{
+		return describe_lanes(v);
+	}
+
+	template <typename V, size_t Count>
+	std::string describe(neon::neon_tuple<V, Count> const& v)
+	{
+		std::string s = "[";
+		for (size_t r = 0; r < Count; r++)
+			s += (r ? ", " : "") + describe(v.val[r]);
+		return s + "]";
+	}
+
+	template <typename T>
+	std::string describe(T* const& p)
+	{
+		using lane_type = typename std::remove_const<T>::type;
+		std::string s = "&{";
+		for (size_t i = 0; i < 64 / sizeof(lane_type); i++)
+		{
+			lane_type lane;
+			std::memcpy(&lane, reinterpret_cast<unsigned char const*>(p) + i * sizeof(lane_type), sizeof(lane_type));
+			s += (i ? ", " : "") + hex(lane);
+		}
+		return s + "}";
+	}
+
+	// Result of one call; stores have none and are compared through memory.
+	template <typename R>
+	struct outcome
+	{
+		R value;
+		bool qc;
+	};
+
+	template <>
+	struct outcome<void>
+	{
+		bool qc;
+	};
+
+	template <typename R, typename... A, typename Inputs, size_t... I>
+	typename std::enable_if<!std::is_void<R>::value, outcome<R>>::type
+		call(R (*f)(A...), Inputs& in, std::index_sequence<I...>)
+	{
+		neon::fpsr_qc() = false;
+		R r = f(std::get<I>(in)...);
+		return { r, neon::fpsr_qc() };
+	}
+
+	template <typename R, typename... A, typename Inputs, size_t... I>
+	typename std::enable_if<std::is_void<R>::value, outcome<R>>::type
+		call(R (*f)(A...), Inputs& in, std::index_sequence<I...>)
+	{
+		neon::fpsr_qc() = false;
+		f(std::get<I>(in)...);
+		return { neon::fpsr_qc() };
+	}
+
+	template <typename R>
+	int first_diff(outcome<R> const& a, outcome<R> const& b)
+	{
+		return first_diff(a.value, b.value);
+	}
+
+	inline int first_diff(outcome<void> const&, outcome<void> const&)
+	{
+		return -1;
+	}
+
+	template <typename R>
+	std::string describe(outcome<R> const& r)
+	{
+		return describe(r.value);
+	}
+
+	inline std::string describe(outcome<void> const&)
+	{
+		return "void";
+	}
+
+	template <typename Inputs, size_t... I>
+	std::string describe_inputs(Inputs const& in, std::index_sequence<I...>)
+	{
+		std::string s;
+		int unused[] = { (s += "  a" + std::to_string(I) + " = " + describe(std::get<I>(in)) + "\n", 0)..., 0 };
+		(void)unused;
+		return s;
+	}
+
+	template <typename R, typename... A>
+	void plan(task& t, R (*)(A...))
+	{
+		constexpr unsigned bits[] = { sweep<typename std::decay<A>::type>::bits..., 0 };
+		constexpr unsigned lanes[] = { sweep<typename std::decay<A>::type>::lanes..., 0 };
+
+		t.exhaustive = true;
+		t.bits = 0;
+		t.lanes = 0;
+		for (size_t i = 0; i < sizeof...(A); i++)
+		{
+			t.exhaustive = t.exhaustive && bits[i] != 0;
+			t.bits += bits[i];
+			if (lanes[i] && (!t.lanes || lanes[i] < t.lanes))
+				t.lanes = lanes[i];
+		}
+		t.exhaustive = t.exhaustive && t.bits <= std::min(o.sweep_bits, 32u);
+
+		if (t.exhaustive)
+			t.calls = ((uint64_t(1) << t.bits) + t.lanes - 1) / t.lanes;
+		else
+			t.calls = o.samples;
+	}
+
+	template <typename Inputs, size_t... I>
+	void sweep_inputs(Inputs& in, uint64_t first, unsigned lanes, unsigned const* shifts, std::index_sequence<I...>)
+	{
+		int unused[] = { (set_sweep(std::get<I>(in), first, lanes, shifts[I]), 0)..., 0 };
+		(void)unused;
+	}
+
+	template <typename Inputs, size_t... I>
+	void random_inputs(Inputs& in, std::mt19937_64& rng, scratch& s, unsigned lanes, std::index_sequence<I...>)
+	{
+		int unused[] = { (fill(std::get<I>(in), rng, s, lanes), 0)..., 0 };
+		(void)unused;
+	}
+
+	template <typename Inputs, size_t... I>
+	void retarget_inputs(Inputs& in, scratch& s, std::index_sequence<I...>)
+	{
+		int unused[] = { (retarget(std::get<I>(in), s), 0)..., 0 };
+		(void)unused;
+	}
+
+	template <typename R, typename... A>
+	void run(task& t, uint64_t begin, uint64_t end,
+		R (*scalar)(A...), R (*sse42)(A...), R (*avx2)(A...), R (*avx512)(A...))
+	{
+		using inputs = std::tuple<typename std::decay<A>::type...>;
+		using indexes = std::index_sequence_for<A...>;
+		constexpr unsigned bits[] = { sweep<typename std::decay<A>::type>::bits..., 0 };
+		constexpr bool stores[] = { (std::is_pointer<A>::value && !std::is_const<typename std::remove_pointer<A>::type>::value)..., false };
+		const bool store = std::find(stores, stores + sizeof...(A), true) != stores + sizeof...(A);
+		R (*const backends[])(A...) = { scalar, sse42, avx2, avx512 };
+		const int all = ((2 << top) - 1) & ~1;
+
+		unsigned shifts[sizeof...(A)] = {};
+		for (size_t i = 1; i < sizeof...(A); i++)
+			shifts[i] = shifts[i - 1] + bits[i - 1];
+
+		scratch s = {};
+		std::mt19937_64 rng(std::hash<std::string>()(t.e->name) ^ (begin * 0x9e3779b97f4a7c15ull));
+
+		for (uint64_t c = begin; c < end; c++)
+		{
+			if (t.failed.load(std::memory_order_relaxed) == all)
+				return;
+
+			inputs in;
+			if (t.exhaustive)
+				sweep_inputs(in, c * t.lanes, t.lanes, shifts, indexes());
+			else
+				random_inputs(in, rng, s, t.lanes, indexes());
+
+			std::memcpy(s.out[0], s.in, sizeof(s.in));
+			auto expected = call(scalar, in, indexes());
+
+			for (int b = NEON_BACKEND_SSE42; b <= top; b++)
+			{
+				if (t.failed.load(std::memory_order_relaxed) & (1 << b))
+					continue;
+
+				inputs backend_in = in;
+				retarget_inputs(backend_in, s, indexes());
+				std::memcpy(s.out[1], s.in, sizeof(s.in));
+				auto got = call(backends[b], backend_in, indexes());
+
+				std::string what;
+				char line[160];
+				int lane = first_diff(expected, got);
+				if (lane >= 0)
+					what = "lane " + std::to_string(lane) + " differs";
+				else if (store && std::memcmp(s.out[0], s.out[1], sizeof(s.out[0])) != 0)
+				{
+					size_t at = 0;
+					while (s.out[0][at] == s.out[1][at])
+						at++;
+					std::snprintf(line, sizeof(line), "stored byte %zu is 0x%02x, expected 0x%02x", at, s.out[1][at], s.out[0][at]);
+					what = line;
+				}
+				else if (expected.qc != got.qc)
+				{
+					std::snprintf(line, sizeof(line), "QC is %d, expected %d", int(got.qc), int(expected.qc));
+					what = line;
+				}
+				else
+					continue;
+
+				if (t.failed.fetch_or(1 << b) & (1 << b))
+					continue;
+
+				std::string report = std::string(t.e->name) + " on " + neon::dispatch::backend_name(b) + ": " + what + "\n";
+				report += describe_inputs(in, indexes());
+				report += "  expected " + describe(expected) + "\n";
+				report += "  got      " + describe(got) + "\n";
+				std::lock_guard<std::mutex> lock(t.m);
+				t.mismatch[b] = report;
+			}
+		}
+	}
+
+	// Hands out chunks of the current task; threads move on together once a
+	// task has no calls left.
+	inline void work(std::vector<std::unique_ptr<task>>& tasks, std::atomic<size_t>& cursor)
+	{
+		constexpr uint64_t chunk = 1 << 12;
+		size_t i = cursor.load();
+		while (i < tasks.size())
+		{
+			task& t = *tasks[i];
+			uint64_t begin = t.next.fetch_add(chunk);
+			if (begin >= t.calls)
+			{
+				cursor.compare_exchange_strong(i, i + 1);
+				i = cursor.load();
+				continue;
+			}
+			t.e->run(t, begin, std::min(begin + chunk, t.calls));
+		}
+	}
+
+} // namespace validate
+
+#define NEON_VALIDATE_FUNCTION(name) \
+	{ #name, [](validate::task& t) { validate::plan(t, &neon::scalar::name); }, \
+		[](validate::task& t, uint64_t begin, uint64_t end) { \
+			validate::run(t, begin, end, &neon::scalar::name, &neon::sse42::name, &neon::avx2::name, &neon::avx512::name); \
+		} },
+
+static const validate::entry entries[] = { NEON_API_FUNCTIONS(NEON_VALIDATE_FUNCTION) NEON_API_IMMEDIATE_FUNCTIONS(NEON_VALIDATE_FUNCTION) };
+
+int main(int argc, char** argv)
+{
+	auto& o = validate::o;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string flag = argv[i];
+		if (flag == "--exact-nan") o.exact_nan = true;
+		else if (flag == "--filter" && i + 1 < argc) o.filter = argv[++i];
+		else if (flag == "--threads" && i + 1 < argc) o.threads = unsigned(std::max(1, std::atoi(argv[++i])));
+		else if (flag == "--samples" && i + 1 < argc) o.samples = std::strtoull(argv[++i], nullptr, 0);
+		else if (flag == "--sweep-bits" && i + 1 < argc) o.sweep_bits = unsigned(std::atoi(argv[++i]));
+		else
+		{
+			std::fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	validate::top = neon::dispatch::backend();
+	if (validate::top == NEON_BACKEND_SCALAR)
+	{
+		std::printf("no x86 backend on this host, nothing to compare\n");
+		return 0;
+	}
+
+	std::vector<std::unique_ptr<validate::task>> tasks;
+	uint64_t calls = 0;
+	size_t exhaustive = 0;
+	for (auto& e : entries)
+	{
+		if (!o.filter.empty() && !std::strstr(e.name, o.filter.c_str()))
+			continue;
+		tasks.emplace_back(new validate::task);
+		tasks.back()->e = &e;
+		e.plan(*tasks.back());
+		calls += tasks.back()->calls;
+		exhaustive += tasks.back()->exhaustive;
+	}
+
+	std::printf("%zu functions (%zu exhaustive, %zu sampled), %llu calls per backend up to %s, %u threads\n",
+		tasks.size(), exhaustive, tasks.size() - exhaustive, (unsigned long long)calls,
+		neon::dispatch::backend_name(validate::top), o.threads);
+	std::fflush(stdout);
+
+	auto t0 = std::chrono::steady_clock::now();
+	std::atomic<size_t> cursor{ 0 };
+	std::vector<std::thread> pool;
+	for (unsigned i = 0; i < o.threads; i++)
+		pool.emplace_back(validate::work, std::ref(tasks), std::ref(cursor));
+	for (auto& th : pool)
+		th.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	size_t failed = 0;
+	for (auto& t : tasks)
+	{
+		failed += t->failed != 0;
+		for (auto& m : t->mismatch)
+			std::fputs(m.c_str(), stdout);
+	}
+	std::printf("%zu of %zu functions mismatch, %.1f s\n", failed, tasks.size(), seconds);
+	return failed ? 1 : 0;
+}